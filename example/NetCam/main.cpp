@@ -2,6 +2,9 @@
 #include "infinite_sense.h"
 // 加入工业相机头文件
 #include "mv_cam.h"
+// 原始帧与多相机帧组
+#include "raw_frame.h"
+#include "frameset.h"
 using namespace infinite_sense;
 // 自定义回调函数
 void ImuCallback(const void *msg, size_t) {
@@ -12,28 +15,53 @@ void ImuCallback(const void *msg, size_t) {
   // 处理IMU数据
 }
 
-// 自定义回调函数
-void ImageCallback(const void *msg, size_t) {
-  const auto *cam_data = static_cast<const CamData *>(msg);
+// 自定义回调函数：相机原始帧，需要时再取 frame->Bgr() 或 frame->Gray()，转换结果缓存在帧上
+void ImageCallback(const std::shared_ptr<const RawFrame> &frame) {
+  if (!frame->Triggered()) {
+    return;  // 尚未关联到触发的帧没有可用的时间戳
+  }
   // 处理图像数据
 }
 
+// 自定义回调函数：同一次触发的所有相机图像
+void FrameSetCallback(const std::shared_ptr<const FrameSet> &frame_set) {
+  for (const auto &frame : frame_set->frames) {
+    if (frame) {
+      // 处理图像数据，frame 与单相机原始帧共享，转换结果同样共享
+    }
+  }
+}
+
 int main() {
   // 1.创建同步器
   Synchronizer synchronizer;
   // synchronizer.SetUsbLink("/dev/ttyACM0", 921600);
   synchronizer.SetNetLink("192.168.1.188", 8888);
+  // 触发统一发布到 "trigger" 话题；需要按通道的 "cam_1_trigger" 等话题（如 monitor 查看各通道频率）时开启
+  // TriggerManger::GetInstance().SetChannelTopics(true);
   // 2.配置同步接口
   auto mv_cam = std::make_shared<MvCam>();
   mv_cam->SetParams({{"cam_1", CAM_1}});
+  // 默认同时发布 Messenger 的 CamData 话题（每帧在取图线程中转换为 BGR）；只用 RawFrameHub 的原始帧时关闭
+  // mv_cam->SetPublishBgr(false);
+  // 触发到取图的延迟可能超过一个触发周期时给出延迟范围（us），否则帧会关联到更新的触发
+  // mv_cam->SetLatencyRange("cam_1", 60000, 90000);
+  // 多相机时可按触发聚合为帧组
+  // auto frame_set = std::make_shared<FrameSetAggregator>(FrameSetConfig{{"cam_1", "cam_2"}});
+  // frame_set->Subscribe(FrameSetCallback);
+  // mv_cam->SetFrameSet(frame_set);
   synchronizer.UseSensor(mv_cam);
 
+  // 激光雷达授时：LIDAR_1 通道的 PPS 发布为 LaserData，并生成 GPRMC 语句（需 #include "laser.h"）
+  // LaserManager::GetInstance().AddChannel(LIDAR_1, "lidar_1");
+  // LaserManager::GetInstance().SetNmea(true, [](const std::string &sentence) { /* 写入激光雷达串口 */ });
+
   // 3.开启同步
   synchronizer.Start();
 
   // 4.接收数据
   Messenger::GetInstance().SubStruct("imu_1", ImuCallback);
-  Messenger::GetInstance().SubStruct("cam_1", ImageCallback);
+  RawFrameHub::GetInstance().Subscribe("cam_1", ImageCallback);
   // 阻塞线程
   while (true) {
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -1,5 +1,6 @@
 #include "infinite_sense.h"
 #include "mv_cam.h"
+#include "raw_frame.h"
 #include <ros/ros.h>
 #include <cv_bridge/cv_bridge.h>
 #include <image_transport/image_transport.h>
@@ -38,7 +39,7 @@ class OptimizedMultiCamDriver {
       
       sensor_msgs::Imu imu_msg_data;
       imu_msg_data.header.frame_id = "imu";
-      imu_msg_data.header.stamp = CreateRosTimestamp(imu_data->time_stamp_us);
+      imu_msg_data.header.stamp = CreateRosTimestamp(HostClock::ToWallUs(imu_data->time_stamp_us));
       
       imu_msg_data.angular_velocity.x = imu_data->g[0];
       imu_msg_data.angular_velocity.y = imu_data->g[1];
@@ -66,24 +67,13 @@ class OptimizedMultiCamDriver {
   }
 
   // **修复段错误的安全图像处理**
-  void ImageCallback(const std::string& camera_name, const void *msg, size_t size) {
-    if (!msg || !ros::ok()) {
+  void ImageCallback(const std::string& camera_name, const std::shared_ptr<const RawFrame> &frame) {
+    // 尚未关联到触发的帧没有可用的时间戳，不发布
+    if (!frame || !frame->Triggered() || !ros::ok()) {
       return;
     }
     
     try {
-      const auto *cam_data = static_cast<const CamData *>(msg);
-      
-      // 更严格的数据验证
-      if (!cam_data || !cam_data->image.data) {
-        return;
-      }
-      
-      // 获取实际图像尺寸
-      const int actual_height = cam_data->image.rows;
-      const int actual_width = cam_data->image.cols;
-      const size_t actual_data_size = actual_height * actual_width * 4;
-      
       // **关键修复：线程安全的发布器检查**
       bool has_subscribers = false;
       {
@@ -94,7 +84,7 @@ class OptimizedMultiCamDriver {
         }
       }
       
-      // **性能优化：无订阅者时跳过图像处理**
+      // **性能优化：无订阅者时跳过图像处理，原始帧不做颜色转换**
       if (!has_subscribers) {
         // 只更新计数，不处理图像
         std::lock_guard<std::mutex> lock(stats_mutex_);
@@ -102,6 +92,16 @@ class OptimizedMultiCamDriver {
         return;
       }
       
+      // 首次取用时转换为 BGR，同一帧的其它消费者共享转换结果
+      const GMat &image = frame->Bgr();
+      if (image.Empty()) {
+        ROS_ERROR_THROTTLE(5.0, "%s: Unsupported raw frame", camera_name.c_str());
+        return;
+      }
+      const int actual_height = image.rows;
+      const int actual_width = image.cols;
+      const size_t actual_data_size = static_cast<size_t>(actual_height) * actual_width * 3;
+      
       // **安全的图像消息创建**
       sensor_msgs::ImagePtr image_msg;
       try {
@@ -111,24 +111,17 @@ class OptimizedMultiCamDriver {
           return;
         }
         
-        image_msg->header.stamp = CreateRosTimestamp(cam_data->time_stamp_us);
+        image_msg->header.stamp = CreateRosTimestamp(HostClock::ToWallUs(frame->TimeStampUs()));
         image_msg->header.frame_id = camera_name;
         image_msg->height = actual_height;
         image_msg->width = actual_width;
         image_msg->encoding = "bgr8";
         image_msg->is_bigendian = false;
-        image_msg->step = actual_width * 4;
+        image_msg->step = actual_width * 3;
         
         // **安全的内存分配和拷贝**
         image_msg->data.resize(actual_data_size);
-        
-        // 验证源数据指针
-        if (cam_data->image.data) {
-          memcpy(image_msg->data.data(), cam_data->image.data, actual_data_size);
-        } else {
-          ROS_ERROR_THROTTLE(5.0, "%s: NULL image data pointer", camera_name.c_str());
-          return;
-        }
+        memcpy(image_msg->data.data(), image.data, actual_data_size);
         
         // **线程安全发布**
         {
@@ -192,6 +185,8 @@ class OptimizedMultiCamDriver {
     }
     
     mv_cam_->SetParams(camera_configs);
+    // 图像从 RawFrameHub 取得，不需要 Messenger 的 CamData 话题
+    mv_cam_->SetPublishBgr(false);
     synchronizer_.UseSensor(mv_cam_);
     
     // 设置发布器
@@ -245,9 +240,9 @@ class OptimizedMultiCamDriver {
     
     // **动态订阅所有检测到的相机**
     for (const auto& cam_name : camera_names_) {
-      Messenger::GetInstance().SubStruct(
-          cam_name, [this, cam_name](const void* msg, size_t size) {
-            this->ImageCallback(cam_name, msg, size);
+      RawFrameHub::GetInstance().Subscribe(
+          cam_name, [this, cam_name](const std::shared_ptr<const RawFrame> &frame) {
+            this->ImageCallback(cam_name, frame);
           });
       ROS_INFO("Subscribed to camera: %s", cam_name.c_str());
     }
@@ -1,5 +1,6 @@
 #include "infinite_sense.h"
 #include "mv_cam.h"
+#include "raw_frame.h"
 
 #include "rclcpp/rclcpp.hpp"
 
@@ -18,6 +19,8 @@ class CamDriver final : public rclcpp::Node {
     synchronizer_.SetNetLink("192.168.1.188", 8888);
     const auto mv_cam = std::make_shared<infinite_sense::MvCam>();
     mv_cam->SetParams({{camera_name, infinite_sense::CAM_1}});
+    // 图像从 RawFrameHub 取得，不需要 Messenger 的 CamData 话题
+    mv_cam->SetPublishBgr(false);
     synchronizer_.UseSensor(mv_cam);
     synchronizer_.Start();
     imu_pub_ = this->create_publisher<sensor_msgs::msg::Imu>(imu_name, 10);
@@ -25,15 +28,14 @@ class CamDriver final : public rclcpp::Node {
     {
       using namespace std::placeholders;
       infinite_sense::Messenger::GetInstance().SubStruct(imu_name, std::bind(&CamDriver::ImuCallback, this, _1, _2));
-      infinite_sense::Messenger::GetInstance().SubStruct(camera_name,
-                                                         std::bind(&CamDriver::ImageCallback, this, _1, _2));
+      infinite_sense::RawFrameHub::GetInstance().Subscribe(camera_name, std::bind(&CamDriver::ImageCallback, this, _1));
     }
   }
 
   void ImuCallback(const void *msg, size_t) const {
     const auto *imu_data = static_cast<const infinite_sense::ImuData *>(msg);
     sensor_msgs::msg::Imu imu_msg;
-    imu_msg.header.stamp = rclcpp::Time(imu_data->time_stamp_us * 1000);
+    imu_msg.header.stamp = rclcpp::Time(infinite_sense::HostClock::ToWallUs(imu_data->time_stamp_us) * 1000);
     imu_msg.header.frame_id = "map";
     imu_msg.linear_acceleration.x = imu_data->a[0];
     imu_msg.linear_acceleration.y = imu_data->a[1];
@@ -48,12 +50,20 @@ class CamDriver final : public rclcpp::Node {
     imu_pub_->publish(imu_msg);
   }
 
-  void ImageCallback(const void *msg, size_t) const {
-    const auto *cam_data = static_cast<const infinite_sense::CamData *>(msg);
+  void ImageCallback(const std::shared_ptr<const infinite_sense::RawFrame> &frame) const {
+    // 尚未关联到触发的帧没有可用的时间戳，不发布
+    if (img_pub_.getNumSubscribers() == 0 || !frame->Triggered()) {
+      return;
+    }
+    // 只需要灰度图像，Bayer 原始帧直接转为灰度，不经过 BGR
+    const infinite_sense::GMat &gray = frame->Gray();
+    if (gray.Empty()) {
+      return;
+    }
     std_msgs::msg::Header header;
-    header.stamp = rclcpp::Time(cam_data->time_stamp_us * 1000);
+    header.stamp = rclcpp::Time(infinite_sense::HostClock::ToWallUs(frame->TimeStampUs()) * 1000);
     header.frame_id = "map";
-    const cv::Mat image_mat(cam_data->image.rows, cam_data->image.cols, CV_8UC1, cam_data->image.data);
+    const cv::Mat image_mat(gray.rows, gray.cols, CV_8UC1, gray.data);
     const sensor_msgs::msg::Image::SharedPtr image_msg = cv_bridge::CvImage(header, "mono8", image_mat).toImageMsg();
     img_pub_.publish(image_msg);
   }
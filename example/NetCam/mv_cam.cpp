@@ -1,7 +1,14 @@
 #include "mv_cam.h"
 #include "infinite_sense.h"
+#include "frame_matcher.h"
+#include "frameset.h"
+#include "drop_monitor.h"
+#include "latency_model.h"
+#include "demosaic.h"
+#include "raw_frame.h"
 #include "MvCameraControl.h"
 #include <cstring>        // for memset, strlen
+#include <memory>         // for std::unique_ptr
 #include <string>         // for std::string
 #include <vector>         // for std::vector
 
@@ -79,6 +86,109 @@ bool IsMono(const MvGvspPixelType type) {
   }
 }
 
+// Bayer 像素格式对应的排列、位深与打包方式，不支持的格式返回 false
+bool ToBayerImage(const MvGvspPixelType type, BayerImage &image) {
+  switch (type) {
+    case PixelType_Gvsp_BayerGR8:
+    case PixelType_Gvsp_BayerGR10:
+    case PixelType_Gvsp_BayerGR10_Packed:
+    case PixelType_Gvsp_BayerGR12:
+    case PixelType_Gvsp_BayerGR12_Packed:
+      image.pattern = BayerPattern::GRBG;
+      break;
+    case PixelType_Gvsp_BayerRG8:
+    case PixelType_Gvsp_BayerRG10:
+    case PixelType_Gvsp_BayerRG10_Packed:
+    case PixelType_Gvsp_BayerRG12:
+    case PixelType_Gvsp_BayerRG12_Packed:
+      image.pattern = BayerPattern::RGGB;
+      break;
+    case PixelType_Gvsp_BayerGB8:
+    case PixelType_Gvsp_BayerGB10:
+    case PixelType_Gvsp_BayerGB10_Packed:
+    case PixelType_Gvsp_BayerGB12:
+    case PixelType_Gvsp_BayerGB12_Packed:
+      image.pattern = BayerPattern::GBRG;
+      break;
+    case PixelType_Gvsp_BayerBG8:
+    case PixelType_Gvsp_BayerBG10:
+    case PixelType_Gvsp_BayerBG10_Packed:
+    case PixelType_Gvsp_BayerBG12:
+    case PixelType_Gvsp_BayerBG12_Packed:
+      image.pattern = BayerPattern::BGGR;
+      break;
+    default:
+      return false;
+  }
+  switch (type) {
+    case PixelType_Gvsp_BayerGR8:
+    case PixelType_Gvsp_BayerRG8:
+    case PixelType_Gvsp_BayerGB8:
+    case PixelType_Gvsp_BayerBG8:
+      image.bit_depth = 8;
+      break;
+    case PixelType_Gvsp_BayerGR10:
+    case PixelType_Gvsp_BayerRG10:
+    case PixelType_Gvsp_BayerGB10:
+    case PixelType_Gvsp_BayerBG10:
+    case PixelType_Gvsp_BayerGR10_Packed:
+    case PixelType_Gvsp_BayerRG10_Packed:
+    case PixelType_Gvsp_BayerGB10_Packed:
+    case PixelType_Gvsp_BayerBG10_Packed:
+      image.bit_depth = 10;
+      break;
+    default:
+      image.bit_depth = 12;
+      break;
+  }
+  switch (type) {
+    case PixelType_Gvsp_BayerGR10_Packed:
+    case PixelType_Gvsp_BayerRG10_Packed:
+    case PixelType_Gvsp_BayerGB10_Packed:
+    case PixelType_Gvsp_BayerBG10_Packed:
+    case PixelType_Gvsp_BayerGR12_Packed:
+    case PixelType_Gvsp_BayerRG12_Packed:
+    case PixelType_Gvsp_BayerGB12_Packed:
+    case PixelType_Gvsp_BayerBG12_Packed:
+      image.packed = true;
+      break;
+    default:
+      image.packed = false;
+      break;
+  }
+  return true;
+}
+
+// 帧信息对应的原始图像格式，不支持的像素格式返回 false
+bool ToRawFormat(const MV_FRAME_OUT_INFO_EX &info, RawFormat &format) {
+  format.width = info.nWidth;
+  format.height = info.nHeight;
+  if (BayerImage bayer; ToBayerImage(info.enPixelType, bayer)) {
+    format.pixel = PixelFormat::BAYER;
+    format.pattern = bayer.pattern;
+    format.bit_depth = bayer.bit_depth;
+    format.packed = bayer.packed;
+    format.stride = bayer.bit_depth == 8 ? info.nWidth : (bayer.packed ? info.nWidth / 2 * 3 : info.nWidth * 2);
+    return true;
+  }
+  switch (info.enPixelType) {
+    case PixelType_Gvsp_Mono8:
+      format.pixel = PixelFormat::MONO8;
+      format.stride = info.nWidth;
+      return true;
+    case PixelType_Gvsp_BGR8_Packed:
+      format.pixel = PixelFormat::BGR8;
+      format.stride = static_cast<size_t>(info.nWidth) * 3;
+      return true;
+    case PixelType_Gvsp_RGB8_Packed:
+      format.pixel = PixelFormat::RGB8;
+      format.stride = static_cast<size_t>(info.nWidth) * 3;
+      return true;
+    default:
+      return false;
+  }
+}
+
 bool PrintDeviceInfo(const MV_CC_DEVICE_INFO *info) {
   if (info == nullptr) {
     LOG(WARNING) << "[WARNING] Failed to get camera details. Skipping...";
@@ -273,6 +383,12 @@ bool MvCam::Initialization() {
       }
     }
     
+    // 在帧信息中附带每帧的曝光时间，时间戳按实际曝光计算，不必在采集中查询相机
+    if (MV_CC_SetEnumValueByString(handles_[i], "FrameSpecInfoSelector", "Exposure") != MV_OK ||
+        MV_CC_SetBoolValue(handles_[i], "FrameSpecInfo", true) != MV_OK) {
+      LOG(WARNING) << camera_name << " does not support per-frame exposure info";
+    }
+    
     // 开始抓图
     rets_[i] = MV_CC_StartGrabbing(handles_[i]);
     if (MV_OK != rets_[i]) {
@@ -307,6 +423,9 @@ void MvCam::Stop() {
     }
   }
   cam_threads.clear();
+  if (frameset) {
+    frameset->Flush();
+  }
   
   // **修复：安全地关闭所有相机**
   for (size_t i = 0; i < handles_.size(); ++i) {
@@ -336,6 +455,10 @@ void MvCam::Receive(void *handle, const std::string &name) {
   MV_FRAME_OUT st_out_frame;
   CamData cam_data;
   Messenger &messenger = Messenger::GetInstance();
+  RawFrameHub &raw_frames = RawFrameHub::GetInstance();
+  RawFrameInfo raw_info{};
+  raw_info.name = name;
+  const std::string raw_topic = name + "_raw";
   
   // **修复：安全的内存分配，添加错误检查**
   unsigned char* p_convert_buffer = nullptr;
@@ -355,6 +478,31 @@ void MvCam::Receive(void *handle, const std::string &name) {
   unsigned long frame_counter = 0;
   unsigned long consecutive_timeouts = 0;
   unsigned long consecutive_errors = 0;
+  // Bayer 转换耗时统计，每 5000 帧输出一次后清零
+  double convert_us = 0;
+  unsigned long convert_frames = 0;
+  unsigned long sdk_frames = 0;
+
+  // 每个相机各自的曝光时间（us），帧信息不带曝光时间时每 100 帧从相机读取一次
+  float expose_time_us = 10000.0f;
+  if (MVCC_FLOATVALUE expose_time{}; MV_CC_GetFloatValue(handle, "ExposureTime", &expose_time) == MV_OK) {
+    expose_time_us = expose_time.fCurValue;
+  }
+
+  // 按相机帧计数关联触发，每个相机线程一个实例
+  std::unique_ptr<FrameTriggerMatcher> matcher;
+  // 比较触发数与帧计数，统计漏触发、丢帧与积压
+  std::unique_ptr<FrameDropMonitor> drops;
+  // 触发到取得图像的延迟模型，用于收紧按时间关联的触发上限
+  std::unique_ptr<CaptureLatencyModel> latency;
+  if (params.find(name) != params.end()) {
+    matcher = std::make_unique<FrameTriggerMatcher>(params[name], name);
+    drops = std::make_unique<FrameDropMonitor>(params[name], name);
+    latency = std::make_unique<CaptureLatencyModel>(params[name], name);
+    if (const auto range = latency_ranges_.find(name); range != latency_ranges_.end()) {
+      latency->SetPriorRange(range->second.first, range->second.second);
+    }
+  }
   
   LOG(INFO) << name << " receive thread started with safety fixes";
   
@@ -369,31 +517,82 @@ void MvCam::Receive(void *handle, const std::string &name) {
       }
       
       int n_ret = MV_CC_GetImageBuffer(handle, &st_out_frame, timeout_ms);
+      const uint64_t arrival_ns = HostClock::NowNs();
       if (n_ret == MV_OK && st_out_frame.pBufAddr != nullptr) {
         frame_counter++;
         consecutive_timeouts = 0;
         consecutive_errors = 0;
         
-        // **优化：缓存曝光时间**
-        static MVCC_FLOATVALUE cached_expose_time = {0, 0, 10000.0f};
-        if (frame_counter % 100 == 0) {
-          if (MV_CC_GetExposureTime(handle, &cached_expose_time) != MV_OK) {
-            cached_expose_time.fCurValue = 10000.0f;  // 默认值
+        // 曝光时间：使用帧信息中该帧的实际曝光，自动曝光时逐帧变化；帧信息不带曝光时间时定期读取相机参数，
+        // 读取是一次控制通道往返，不放在每帧路径上
+        if (st_out_frame.stFrameInfo.fExposureTime > 0) {
+          expose_time_us = st_out_frame.stFrameInfo.fExposureTime;
+        } else {
+          if (frame_counter == 1) {
+            LOG(WARNING) << name << " frame info carries no exposure time, reading it from the camera every 100 frames";
+          }
+          if (MVCC_FLOATVALUE expose_time{};
+              frame_counter % 100 == 0 && MV_CC_GetFloatValue(handle, "ExposureTime", &expose_time) == MV_OK) {
+            expose_time_us = expose_time.fCurValue;
           }
         }
         
-        // 时间戳设置
-        if (params.find(name) != params.end()) {
-          if (uint64_t time; GET_LAST_TRIGGER_STATUS(params[name], time)) {
-            cam_data.time_stamp_us = time + static_cast<uint64_t>(cached_expose_time.fCurValue / 2.);
+        // 时间戳设置：按相机帧计数取得对应的触发，对齐前在延迟模型给出的时间范围内查找唯一的触发；
+        // 找不到触发的帧时间戳为 0 并标记为未关联，不沿用上一帧的时间戳
+        TriggerEvent trigger;
+        bool triggered = false;
+        cam_data.time_stamp_us = 0;
+        if (matcher) {
+          const auto expose_us = static_cast<uint64_t>(expose_time_us);
+          const uint64_t arrival_us = TimeTranslator::GetInstance().ToDeviceTime(arrival_ns);
+          const TriggerWindow window = latency->Window(arrival_us, expose_time_us);
+          triggered = matcher->Match(st_out_frame.stFrameInfo.nFrameNum, window, trigger);
+          if (triggered) {
+            cam_data.time_stamp_us = trigger.time_us + expose_us / 2;
+          }
+          // 只用按帧计数锁定后的帧更新延迟模型
+          if (triggered && matcher->GetStats().locked) {
+            latency->Record(arrival_us, trigger.time_us, expose_time_us);
           }
+          drops->Update(st_out_frame.stFrameInfo.nFrameNum, triggered ? &trigger : nullptr, window);
         }
+        const bool to_frameset = frameset && triggered;
         
         bool image_processed = false;
         
         // **修复：更安全的像素类型处理**
         try {
-          if (IsBayer(st_out_frame.stFrameInfo.enPixelType)) {
+          // 原始帧：格式信息每帧发布到 Messenger；有订阅者或帧组时拷贝一次原始数据发布，
+          // 颜色转换由第一个需要的消费者触发
+          if (RawFormat format; ToRawFormat(st_out_frame.stFrameInfo, format)) {
+            raw_info.time_stamp_us = cam_data.time_stamp_us;
+            raw_info.triggered = triggered;
+            raw_info.frame_num = st_out_frame.stFrameInfo.nFrameNum;
+            raw_info.size = st_out_frame.stFrameInfo.nFrameLen;
+            raw_info.format = format;
+            {
+              std::lock_guard<std::mutex> lock(messenger_mutex_);
+              messenger.PubStruct(raw_topic, &raw_info, sizeof(raw_info));
+            }
+            if (to_frameset || raw_frames.HasSubscribers(name)) {
+              const auto raw = std::make_shared<const RawFrame>(cam_data.time_stamp_us, triggered, name, format,
+                                                                st_out_frame.pBufAddr,
+                                                                st_out_frame.stFrameInfo.nFrameLen);
+              raw_frames.Publish(raw);
+              if (to_frameset) {
+                frameset->Add(name, trigger, raw);
+              }
+            }
+            image_processed = true;
+          } else if (frame_counter == 1) {
+            LOG(WARNING) << name << " unsupported pixel type 0x" << std::hex << st_out_frame.stFrameInfo.enPixelType
+                         << std::dec << " for raw frames";
+          }
+          
+          // 兼容 Messenger 的 CamData 话题，默认开启，SetPublishBgr(false) 关闭；每帧在取图线程中转换。
+          // CamData 没有关联标志，有触发通道但没有关联到触发的帧不发布
+          const bool publish_bgr = publish_bgr_ && (!matcher || triggered);
+          if (publish_bgr && IsBayer(st_out_frame.stFrameInfo.enPixelType)) {
             // **动态处理图像尺寸，不做严格限制**
             const unsigned int frame_width = st_out_frame.stFrameInfo.nWidth;
             const unsigned int frame_height = st_out_frame.stFrameInfo.nHeight;
@@ -406,23 +605,38 @@ void MvCam::Receive(void *handle, const std::string &name) {
               continue;
             }
             
-            MV_CC_PIXEL_CONVERT_PARAM st_convert_param;
-            memset(&st_convert_param, 0, sizeof(MV_CC_PIXEL_CONVERT_PARAM));
-            st_convert_param.nWidth = frame_width;
-            st_convert_param.nHeight = frame_height;
-            st_convert_param.pSrcData = st_out_frame.pBufAddr;
-            st_convert_param.nSrcDataLen = st_out_frame.stFrameInfo.nFrameLen;
-            st_convert_param.enSrcPixelType = st_out_frame.stFrameInfo.enPixelType;
-            st_convert_param.enDstPixelType = PixelType_Gvsp_BGR8_Packed;
-            st_convert_param.pDstBuffer = p_convert_buffer;
-            st_convert_param.nDstBufferSize = converted_size;
+            GMat image(frame_height, frame_width, GMatType<uint8_t, 3>::Type, p_convert_buffer);
             
-            n_ret = MV_CC_ConvertPixelType(handle, &st_convert_param);
+            // 默认在本线程内用 SIMD 去马赛克，格式不支持或数据长度不足时回退到相机 SDK 转换
+            const auto convert_begin = std::chrono::steady_clock::now();
+            bool converted = false;
+            if (RawFormat format; !sdk_convert_ && ToRawFormat(st_out_frame.stFrameInfo, format)) {
+              const BayerImage bayer{st_out_frame.pBufAddr, format.width, format.height, format.stride,
+                                     format.pattern, format.bit_depth, format.packed};
+              converted = format.stride * frame_height <= st_out_frame.stFrameInfo.nFrameLen &&
+                          DemosaicBayer(bayer, image.data, static_cast<size_t>(frame_width) * 3);
+            }
+            n_ret = MV_OK;
+            if (!converted) {
+              MV_CC_PIXEL_CONVERT_PARAM st_convert_param;
+              memset(&st_convert_param, 0, sizeof(MV_CC_PIXEL_CONVERT_PARAM));
+              st_convert_param.nWidth = frame_width;
+              st_convert_param.nHeight = frame_height;
+              st_convert_param.pSrcData = st_out_frame.pBufAddr;
+              st_convert_param.nSrcDataLen = st_out_frame.stFrameInfo.nFrameLen;
+              st_convert_param.enSrcPixelType = st_out_frame.stFrameInfo.enPixelType;
+              st_convert_param.enDstPixelType = PixelType_Gvsp_BGR8_Packed;
+              st_convert_param.pDstBuffer = image.data;
+              st_convert_param.nDstBufferSize = converted_size;
+              n_ret = MV_CC_ConvertPixelType(handle, &st_convert_param);
+            }
             if (MV_OK == n_ret) {
+              const auto convert_time = std::chrono::steady_clock::now() - convert_begin;
+              convert_us += std::chrono::duration<double, std::micro>(convert_time).count();
+              ++convert_frames;
+              sdk_frames += converted ? 0 : 1;
               cam_data.name = name;
-              cam_data.image = GMat(frame_height, frame_width,
-                                    GMatType<uint8_t, 3>::Type, 
-                                    p_convert_buffer);
+              cam_data.image = image;
               
               // **线程安全发布**
               {
@@ -437,8 +651,8 @@ void MvCam::Receive(void *handle, const std::string &name) {
                           << "] errors: " << consecutive_errors;
               }
             }
-          } else if (st_out_frame.stFrameInfo.enPixelType == PixelType_Gvsp_BGR8_Packed || 
-                     st_out_frame.stFrameInfo.enPixelType == PixelType_Gvsp_RGB8_Packed) {
+          } else if (publish_bgr && (st_out_frame.stFrameInfo.enPixelType == PixelType_Gvsp_BGR8_Packed ||
+                                     st_out_frame.stFrameInfo.enPixelType == PixelType_Gvsp_RGB8_Packed)) {
             // **直接使用，动态处理尺寸**
             cam_data.name = name;
             cam_data.image = GMat(st_out_frame.stFrameInfo.nHeight, 
@@ -452,7 +666,6 @@ void MvCam::Receive(void *handle, const std::string &name) {
             }
             image_processed = true;
           }
-          
         } catch (const std::exception& e) {
           consecutive_errors++;
           LOG(ERROR) << name << " image processing exception: " << e.what();
@@ -463,10 +676,26 @@ void MvCam::Receive(void *handle, const std::string &name) {
           LOG(INFO) << name << " processed " << frame_counter << " frames (" 
                     << st_out_frame.stFrameInfo.nWidth << "x" 
                     << st_out_frame.stFrameInfo.nHeight << ")";
+          if (matcher) {
+            const FrameMatchStats stats = matcher->GetStats();
+            LOG(INFO) << name << " trigger match: counter " << stats.by_counter << ", time " << stats.by_time
+                      << ", unmatched " << stats.unmatched << ", mismatches " << stats.mismatches;
+          }
+          if (convert_frames > 0) {
+            LOG(INFO) << name << " bayer convert: " << convert_us / convert_frames << " us/frame, sdk "
+                      << sdk_frames << "/" << convert_frames;
+            convert_us = 0;
+            convert_frames = 0;
+            sdk_frames = 0;
+          }
         }
         
       } else {
         consecutive_timeouts++;
+        if (drops) {
+          drops->Poll();
+          latency->Poll();
+        }
         
         if (consecutive_timeouts % 200 == 0) {
           LOG(WARNING) << name << " consecutive timeouts: " << consecutive_timeouts 
@@ -4,6 +4,9 @@
 #include <vector>         // for std::vector
 #include <string>         // for std::string
 #include <mutex>          // for std::mutex
+#include <atomic>         // for std::atomic
+#include <map>            // for std::map
+#include <utility>        // for std::pair
 
 // 新增：性能优化所需的头文件
 #include <sched.h>        // CPU亲和性设置
@@ -29,11 +32,27 @@ class MvCam final : public Sensor {
   // 新增：获取相机数量
   size_t GetCameraCount() const { return handles_.size(); }
 
+  // Bayer 转 BGR 默认使用 DemosaicBayer，开启后改用相机 SDK 的 MV_CC_ConvertPixelType
+  void SetSdkConvert(bool enable) { sdk_convert_ = enable; }
+
+  // 原始帧通过 RawFrameHub 发布；默认同时在取图线程中转换为 BGR，按 CamData 发布到 Messenger 的相机名称话题。
+  // 只使用 RawFrameHub 的原始帧时可用 SetPublishBgr(false) 关闭，省去每帧的转换与整帧拷贝
+  void SetPublishBgr(bool enable) { publish_bgr_ = enable; }
+
+  // 触发到取图延迟的先验范围（us，含曝光），需在 Start 前调用。默认假定帧在一个触发周期内到达，
+  // 传输时间可能超过一个触发周期时必须设置，否则帧会关联到更新的触发，见 CaptureLatencyModel::SetPriorRange
+  void SetLatencyRange(const std::string &name, double min_us, double max_us) {
+    latency_ranges_[name] = {min_us, max_us};
+  }
+
  private:
   void Receive(void* handle, const std::string&) override;
   std::vector<int> rets_;
   std::vector<void*> handles_;
   std::mutex messenger_mutex_;  // 保护Messenger::PubStruct调用
+  std::atomic<bool> sdk_convert_{false};
+  std::atomic<bool> publish_bgr_{true};
+  std::map<std::string, std::pair<double, double>> latency_ranges_;
   
   // 新增：存储相机名称
   mutable std::vector<std::string> camera_names_;
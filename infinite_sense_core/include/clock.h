@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+
+namespace infinite_sense {
+
+/**
+ * @class HostClock
+ * @brief 时间同步子系统统一使用的主机时钟域。
+ *
+ * 同步板时间跟随主机单调时钟（Linux 下为 CLOCK_MONOTONIC：频率受 NTP 校准但不会被步进），
+ * NTP 对系统时间的步进或调整不会再注入到传感器时间戳中。需要墙上时间（UTC / ROS 时间）时，
+ * 通过单独维护的 墙上时间 - 单调时间 映射换算。
+ *
+ * 不使用 CLOCK_MONOTONIC_RAW：它不受 NTP 频率校准，与墙上时间之间会以晶振误差的速度持续漂移，
+ * 映射需要频繁刷新。
+ */
+class HostClock {
+ public:
+  /// 单调时钟，微秒。
+  static uint64_t NowUs();
+
+  /// 单调时钟，纳秒。
+  static uint64_t NowNs();
+
+  /// 系统墙上时间（UTC），微秒。
+  static uint64_t WallNowUs();
+
+  /**
+   * @brief 当前的 墙上时间 - 单调时间 映射，微秒。
+   *
+   * 每 100 ms 重新测量一次，系统时间被 NTP 步进后映射随之更新，已发布的单调时间戳不受影响。
+   */
+  static int64_t WallOffsetUs();
+
+  /// 单调时间换算为墙上时间（UTC / ROS 时间）。
+  static uint64_t ToWallUs(const uint64_t mono_us) { return mono_us + WallOffsetUs(); }
+
+  /// 墙上时间换算为单调时间。
+  static uint64_t ToMonoUs(const uint64_t wall_us) { return wall_us - WallOffsetUs(); }
+};
+
+}  // namespace infinite_sense
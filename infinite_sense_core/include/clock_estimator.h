@@ -0,0 +1,129 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace infinite_sense {
+
+/**
+ * @brief 设备时钟相对主机时钟的线性模型。
+ *
+ * 设备时间 = 主机时间 + offset_us + skew_ppm * 1e-6 * (主机时间 - ref_host_us)
+ */
+struct ClockModel {
+  bool valid{false};
+  uint64_t ref_host_us{0};  // 模型参考时刻（主机时间）
+  double offset_us{0};      // 参考时刻处的 设备时间 - 主机时间
+  double skew_ppm{0};       // 设备时钟相对主机时钟的频率偏差
+  double residual_us{0};    // 拟合残差的均方根
+  size_t samples{0};        // 参与拟合的样本数
+
+  /// 模型在主机时刻 host_us 处预测的 设备时间 - 主机时间。
+  double OffsetAt(const uint64_t host_us) const {
+    return offset_us + skew_ppm * 1e-6 * static_cast<double>(static_cast<int64_t>(host_us - ref_host_us));
+  }
+};
+
+/**
+ * @class ClockEstimator
+ * @brief 基于滑动窗口线性回归的时钟偏差与漂移估计器。
+ *
+ * 每次 PTP 交换得到一个 (主机时刻, 设备-主机偏差) 样本。由于偏差会回传给同步板用于校正其本地时钟，
+ * 观测到的偏差是锯齿状的；估计器累加已下发的校正量，把样本还原成设备自由运行时的偏差后再拟合，
+ * 从而同时得到当前偏差和晶振漂移。线程安全。
+ */
+class ClockEstimator {
+ public:
+  /**
+   * @param window 参与回归的最大样本数。
+   */
+  explicit ClockEstimator(size_t window = 64);
+
+  /**
+   * @brief 加入一次交换的测量结果。
+   *
+   * @param host_us 测量对应的主机时刻（通常取 t1 与 t4 的中点）。
+   * @param offset_us 测得的 设备时间 - 主机时间。
+   */
+  void AddSample(uint64_t host_us, int64_t offset_us);
+
+  /**
+   * @brief 记录一次已下发给同步板的校正量，同步板据此把本地时钟减去 offset_us。
+   */
+  void ApplyCorrection(int64_t offset_us);
+
+  /// 获取当前模型。
+  ClockModel GetModel() const;
+
+  /// 清空所有样本与校正量。
+  void Reset();
+
+ private:
+  struct Sample {
+    uint64_t host_us;
+    double free_offset_us;  // 加回累计校正量后的自由运行偏差
+  };
+  void Fit();
+
+  size_t window_;
+  std::deque<Sample> samples_{};
+  double correction_us_{0};
+  ClockModel model_{};
+  mutable std::mutex lock_{};
+};
+
+/**
+ * @brief 最小往返时延过滤器的统计信息。
+ */
+struct RttFilterStats {
+  uint64_t exchanges{0};     // 参与过滤的交换总数
+  uint64_t accepted{0};      // 被接受、用于更新偏差的交换数
+  uint64_t rejected{0};      // 因延迟过大被丢弃的交换数
+  int64_t min_delay_us{0};   // 窗口内最小单程延迟
+  int64_t threshold_us{0};   // 当前接受门限
+  int64_t last_delay_us{0};  // 最近一次交换的单程延迟
+};
+
+/**
+ * @class MinRttFilter
+ * @brief 最小往返时延过滤：丢弃延迟明显高于窗口最小延迟的交换。
+ *
+ * 主机线程在 t3 到达与 t4 采样之间被抢占时，会得到延迟偏大且不对称的样本，直接使用会把抢占时间的一半
+ * 计入偏差。过滤器保存最近若干次交换的延迟，门限为窗口最小延迟加 k 倍延迟离散度（中位数绝对偏差换算的
+ * 标准差，且不小于容差）。门限随链路抖动放大，正常抖动的交换大多被接受，只有抢占造成的离群样本被丢弃。
+ * 线程安全。
+ */
+class MinRttFilter {
+ public:
+  /**
+   * @param window 参与统计的最近交换次数。
+   * @param mad_k 门限比窗口最小延迟高出的离散度倍数。
+   * @param margin_us 门限至少比窗口最小延迟高出的容差。
+   */
+  explicit MinRttFilter(size_t window = 32, double mad_k = 4.0, int64_t margin_us = 50);
+
+  /**
+   * @brief 加入一次交换的单程延迟并判断是否接受。
+   *
+   * @return true 该交换可用于更新偏差。
+   */
+  bool Accept(int64_t delay_us);
+
+  RttFilterStats GetStats() const;
+
+  void Reset();
+
+ private:
+  size_t window_;
+  double mad_k_;
+  int64_t margin_us_;
+  std::deque<int64_t> delays_{};
+  std::vector<int64_t> sorted_{};
+  std::vector<int64_t> deviations_{};
+  RttFilterStats stats_{};
+  mutable std::mutex lock_{};
+};
+
+}  // namespace infinite_sense
@@ -1,15 +1,31 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include "image.h"
 namespace infinite_sense {
+// IMU 时间戳调理结果标志位（ImuData::time_flags）
+enum ImuTimeFlag : uint8_t {
+  IMU_TIME_GAP = 1 << 0,       // 采集帧数不连续，中间有样本丢失
+  IMU_TIME_STEP = 1 << 1,      // 采样间隔与标称周期不符（同步板时钟被校正或跳变）
+  IMU_TIME_BACKWARD = 1 << 2,  // 时间戳回退
+  IMU_TIME_RESET = 1 << 3,     // 采集帧数回退，同步板复位
+  IMU_TIME_WRAP = 1 << 4,      // 采集帧数 32 位回绕
+  IMU_TIME_SMOOTHED = 1 << 5,  // time_stamp_us 为按标称周期平滑后的时间
+};
+
+// 所有 time_stamp_us 均为同步板时间，跟随主机单调时钟（见 HostClock），残余偏差与漂移可通过
+// TimeTranslator 换算到主机单调时钟；需要 UTC / ROS 时间时使用 HostClock::ToWallUs 换算。
 struct ImuData {
-  uint64_t time_stamp_us;  // microseconds since start of recording
-  float temperature;       // temperature in Celsius
-  std::string name;        // imu name
-  float a[3];              // accelerometer
-  float g[3];              // gyroscope
-  float q[4];              // quaternion
+  uint64_t time_stamp_us;      // microseconds since start of recording
+  uint64_t raw_time_stamp_us;  // 同步板上报的原始时间戳
+  uint64_t counter;            // 同步板采集帧数
+  uint8_t time_flags;          // ImuTimeFlag 组合，非 0 表示与上一帧之间存在不连续
+  float temperature;           // temperature in Celsius
+  std::string name;            // imu name
+  float a[3];                  // accelerometer
+  float g[3];                  // gyroscope
+  float q[4];                  // quaternion
 };
 
 struct CamData {
@@ -19,8 +35,11 @@ struct CamData {
 };
 
 struct LaserData {
-  uint64_t time_stamp_us;
-  std::string name;
+  uint64_t time_stamp_us;  // PPS 脉冲时间（同步板时间）
+  uint64_t utc_us;         // 脉冲对应的 UTC 整秒（微秒），即 GPRMC 语句中的时间
+  uint64_t seq;            // 同步板采集节拍（"c" 字段）
+  uint64_t index;          // 该通道的脉冲序号（TriggerEvent::index）
+  std::string name;        // 通道名称
 };
 
 struct GPSData {
@@ -30,14 +49,86 @@ struct GPSData {
   std::string data;
 };
 
+// 相机丢帧统计，按相机发布到 "<name>_drops" 话题
+struct FrameDropStats {
+  uint64_t time_stamp_us;    // 主机单调时钟
+  uint64_t frames;           // 收到的帧数
+  uint64_t triggers;         // 自第一帧起该通道的触发数
+  uint64_t missed_triggers;  // 相机没有响应的触发数（相机帧计数少于触发数）
+  uint64_t lost_frames;      // 相机已曝光但没有送达的帧数（相机帧计数不连续，SDK 缓存溢出或传输丢失）
+  uint64_t slow_frames;      // 到达时积压的触发数超过门限的帧数（取图处理跟不上触发）
+  uint64_t untriggered;      // 找不到对应触发的帧数
+  uint32_t backlog;          // 最近一帧到达时已触发但尚未取到的帧数
+  uint32_t max_backlog;      // 本统计周期内的最大积压
+};
+
+// 相机触发到取得图像的延迟直方图桶数：桶 0 为 [0, 1) us，桶 i 为 [2^(i-1), 2^i) us，最后一个桶包含所有更大的值
+constexpr size_t k_latency_histogram_bins = 24;
+
+// 相机触发到取得图像的延迟分布，按相机发布到 "<name>_latency" 话题
+struct CaptureLatency {
+  uint64_t time_stamp_us;                        // 主机单调时钟
+  uint64_t samples;                              // 窗口内的帧数
+  double floor_us;                               // 延迟下限（窗口内 5% 分位数）
+  double p50_us;                                 // 窗口内延迟分位数
+  double p90_us;
+  double p99_us;
+  double max_us;
+  double exposure_us;                            // 最近一帧的曝光时间
+  double transfer_us;                            // 延迟中位数减去曝光时间：读出、传输与取图排队
+  double trigger_period_us;                      // 该通道的触发周期，0 表示未知
+  uint32_t histogram[k_latency_histogram_bins];  // 窗口内的延迟分布
+};
+
+// 时间同步质量直方图的桶数：桶 0 为 [0, 1) us，桶 i 为 [2^(i-1), 2^i) us，最后一个桶包含所有更大的值
+constexpr size_t k_sync_histogram_bins = 16;
+
+// 时间同步状态
+enum SyncState : uint8_t {
+  SYNC_NONE = 0,      // 尚未完成同步
+  SYNC_LOCKED = 1,    // 正常同步
+  SYNC_HOLDOVER = 2,  // 链路中断，按最后的漂移模型外推
+};
+
+struct SyncQuality {
+  uint64_t time_stamp_us;                            // 主机单调时钟
+  bool valid;                                        // 时钟模型是否已建立
+  uint8_t state;                                     // SyncState
+  double uncertainty_us;                             // 设备时间的估计不确定度，保持状态下随时间增长
+  uint64_t since_sync_us;                            // 距最近一次被接受交换的时间
+  int64_t last_offset_us;                            // 最近一次被接受交换测得的 设备 - 主机 偏差
+  double model_offset_us;                            // 时钟模型在当前时刻预测的偏差
+  double skew_ppm;                                   // 估计的晶振漂移
+  double residual_us;                                // 模型拟合残差均方根
+  int64_t rtt_p50_us;                                // 窗口内往返时延分位数
+  int64_t rtt_p90_us;
+  int64_t rtt_p99_us;
+  int64_t rtt_max_us;
+  uint64_t exchanges;                                // 累计交换数
+  uint64_t rejected;                                 // 累计因时延过大被丢弃的交换数
+  uint32_t window_exchanges;                         // 窗口内交换数
+  uint32_t window_rejected;                          // 窗口内被丢弃的交换数
+  uint32_t rtt_histogram[k_sync_histogram_bins];     // 窗口内所有交换的往返时延分布
+  uint32_t offset_histogram[k_sync_histogram_bins];  // 窗口内被接受交换的 |偏差| 分布
+};
+
+// 触发通道，取值即同步板状态位掩码中的位序号；未列出的通道可直接用 static_cast<TriggerDevice>(序号) 使用
 enum TriggerDevice {
-  IMU_1 = 0,  // internal imu
-  IMU_2 = 1,  // external imu
-  CAM_1 = 2,  // camera 1
-  CAM_2 = 3,  // camera 2
-  CAM_3 = 4,  // camera 3
-  CAM_4 = 5,  // camera 4
-  LASER = 6,  // laser pps
-  GPS = 7,    // gps pps
+  IMU_1 = 0,     // internal imu
+  IMU_2 = 1,     // external imu
+  CAM_1 = 2,     // camera 1
+  CAM_2 = 3,     // camera 2
+  CAM_3 = 4,     // camera 3
+  CAM_4 = 5,     // camera 4
+  LASER = 6,     // laser pps
+  GPS = 7,       // gps pps
+  CAM_5 = 8,     // camera 5
+  CAM_6 = 9,     // camera 6
+  CAM_7 = 10,    // camera 7
+  CAM_8 = 11,    // camera 8
+  LIDAR_1 = 12,  // lidar 1
+  LIDAR_2 = 13,  // lidar 2
+  LIDAR_3 = 14,  // lidar 3
+  LIDAR_4 = 15,  // lidar 4
 };
 }  // namespace infinite_sense
@@ -1,5 +1,8 @@
 #pragma once
 #include "infinite_sense.h"
+#include "imu_time.h"
+#include "laser.h"
+#include <json.h>
 
 namespace infinite_sense {
 
@@ -7,9 +10,11 @@ inline void ProcessTriggerData(const nlohmann::json &data) {
   if (data["f"] != "t") {
     return;
   }
-  const uint64_t time_stamp = data["t"];
-  const uint16_t status = data["s"];
-  SET_LAST_TRIGGER_STATUS(time_stamp, status);
+  const uint64_t time_stamp = data.at("t");
+  const uint64_t status = data.at("s");
+  const uint64_t seq = data.value("c", 0ULL);
+  SET_TRIGGER_STATUS(time_stamp, status, seq);
+  LaserManager::GetInstance().Process(time_stamp, status, seq);
 };
 
 inline void ProcessIMUData(const nlohmann::json &data) {
@@ -17,18 +22,23 @@ inline void ProcessIMUData(const nlohmann::json &data) {
     return;
   }
   ImuData imu{};
-  imu.time_stamp_us = data["t"];
-  imu.a[0] = data["d"][0];
-  imu.a[1] = data["d"][1];
-  imu.a[2] = data["d"][2];
-  imu.g[0] = data["d"][3];
-  imu.g[1] = data["d"][4];
-  imu.g[2] = data["d"][5];
-  imu.temperature = data["d"][6];
-  imu.q[0] = data["q"][0];
-  imu.q[1] = data["q"][1];
-  imu.q[2] = data["q"][2];
-  imu.q[3] = data["q"][3];
+  const auto &d = data.at("d");
+  const auto &q = data.at("q");
+  imu.raw_time_stamp_us = data.at("t");
+  imu.counter = data.at("c");
+  imu.a[0] = d.at(0);
+  imu.a[1] = d.at(1);
+  imu.a[2] = d.at(2);
+  imu.g[0] = d.at(3);
+  imu.g[1] = d.at(4);
+  imu.g[2] = d.at(5);
+  imu.temperature = d.at(6);
+  imu.q[0] = q.at(0);
+  imu.q[1] = q.at(1);
+  imu.q[2] = q.at(2);
+  imu.q[3] = q.at(3);
+  // 所有字段解析成功后再更新调理器状态，截断的消息不会影响后续帧
+  imu.time_stamp_us = ImuTimeConditioner::GetInstance().Process(imu.raw_time_stamp_us, imu.counter, imu.time_flags);
   Messenger::GetInstance().PubStruct("imu_1", &imu, sizeof(imu));
 };
 
@@ -37,9 +47,9 @@ inline void ProcessGPSData(const nlohmann::json &data) {
     return;
   }
   GPSData gps{};
-  gps.data = data["d"];
-  gps.trigger_time_us = data["pps"];
-  gps.time_stamp_us = data["t"];
+  gps.data = data.at("d");
+  gps.trigger_time_us = data.at("pps");
+  gps.time_stamp_us = data.at("t");
   Messenger::GetInstance().PubStruct("gps", &gps, sizeof(gps));
 };
 
@@ -47,7 +57,39 @@ inline void ProcessLOGData(const nlohmann::json &data) {
   if (data["f"] != "log") {
     return;
   }
-  LOG(data["l"]) << data["msg"];
+  LOG(data.at("l")) << data.at("msg");
+}
+
+/**
+ * @brief 设备消息统一分发入口（网口、串口、基准测试与模糊测试共用）。
+ *
+ * 只读取一次 "f" 字段并分发到对应的处理函数。字段缺失或类型不符时抛出 nlohmann::json::exception，
+ * 由调用方捕获，不会因截断的消息产生未定义行为。
+ *
+ * @param data 已解析的 JSON 消息。
+ * @return true 消息类型可识别并已处理。
+ */
+inline bool ProcessDeviceMessage(const nlohmann::json &data) {
+  if (!data.is_object()) {
+    return false;
+  }
+  const auto func = data.find("f");
+  if (func == data.end() || !func->is_string()) {
+    return false;
+  }
+  const auto &type = func->get_ref<const std::string &>();
+  if (type == "t") {
+    ProcessTriggerData(data);
+  } else if (type == "imu") {
+    ProcessIMUData(data);
+  } else if (type == "GNGGA") {
+    ProcessGPSData(data);
+  } else if (type == "log") {
+    ProcessLOGData(data);
+  } else {
+    return false;
+  }
+  return true;
 }
 
 }  // namespace infinite_sense
\ No newline at end of file
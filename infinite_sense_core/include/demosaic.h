@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace infinite_sense {
+
+/**
+ * @brief Bayer 排列，以图像左上角 2x2 的颜色命名。
+ */
+enum class BayerPattern {
+  RGGB,
+  BGGR,
+  GRBG,
+  GBRG,
+};
+
+/**
+ * @brief 去马赛克插值方法。
+ */
+enum class DemosaicMethod {
+  BILINEAR,    // 双线性插值
+  EDGE_AWARE,  // R/B 位置的 G 沿梯度较小的方向插值，减少边缘处的拉链效应
+};
+
+/**
+ * @brief 去马赛克使用的指令集，运行时按 CPU 支持情况选择。
+ */
+enum class SimdLevel {
+  SCALAR,
+  SSE4,
+  AVX2,
+};
+
+/**
+ * @brief 一帧 Bayer 原始图像。
+ *
+ * bit_depth 为 8 时每像素 1 字节；为 10/12 时不打包的格式每像素 2 字节（小端，低位对齐），
+ * 打包格式（GigE Vision 10/12 bit packed）每 2 像素 3 字节，宽度须为偶数。
+ */
+struct BayerImage {
+  const uint8_t *data{nullptr};
+  int width{0};
+  int height{0};
+  size_t stride{0};  // 每行字节数
+  BayerPattern pattern{BayerPattern::RGGB};
+  int bit_depth{8};
+  bool packed{false};
+};
+
+/// 当前 CPU 可用的最高指令集。
+SimdLevel BestSimdLevel();
+
+/**
+ * @brief Bayer 原始图像转换为 8 位 BGR 图像。
+ *
+ * 10/12 位输入先截取高 8 位再插值，边界按镜像（不含边界像素）延拓，保持 Bayer 相位。
+ * 各指令集实现的输出逐字节一致。不依赖相机 SDK，可在任意 Sensor 的取图线程中调用。
+ *
+ * @param src 输入图像，宽高至少为 2。
+ * @param bgr 输出缓冲区，至少 height 行，每行 width * 3 字节。
+ * @param bgr_stride 输出每行字节数。
+ * @param method 插值方法。
+ * @param level 使用的指令集，超过 CPU 支持时降级。
+ * @return false 输入格式不支持。
+ */
+bool DemosaicBayer(const BayerImage &src, uint8_t *bgr, size_t bgr_stride,
+                   DemosaicMethod method = DemosaicMethod::BILINEAR, SimdLevel level = BestSimdLevel());
+
+/**
+ * @brief Bayer 原始图像转换为 8 位灰度图像。
+ *
+ * 按行双线性插值后取 BT.601 亮度，与 DemosaicBayer 再 BgrToGrayRow 的结果一致，但不需要整帧的 BGR 缓冲区。
+ *
+ * @param src 输入图像，宽高至少为 2。
+ * @param gray 输出缓冲区，至少 height 行，每行 width 字节。
+ * @param gray_stride 输出每行字节数。
+ * @param level 使用的指令集，超过 CPU 支持时降级。
+ * @return false 输入格式不支持。
+ */
+bool BayerToGray(const BayerImage &src, uint8_t *gray, size_t gray_stride, SimdLevel level = BestSimdLevel());
+
+/// 一行 BGR 转为 BT.601 亮度。
+void BgrToGrayRow(const uint8_t *bgr, uint8_t *gray, int width);
+
+}  // namespace infinite_sense
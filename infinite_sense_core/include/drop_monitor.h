@@ -0,0 +1,81 @@
+#pragma once
+#include "config.h"
+#include "frame_matcher.h"
+#include "trigger.h"
+#include <cstdint>
+#include <string>
+
+namespace infinite_sense {
+
+/**
+ * @class FrameDropMonitor
+ * @brief 逐帧比较相机的触发数、相机帧计数与实际收到的帧数，对丢帧分类统计并每秒发布。
+ *
+ * - 相机漏触发：帧的触发位于延迟模型给出的 [earliest_us, latest_us] 内，早于窗口的触发数（包括丢失的触发消息）
+ *   减去相机帧计数的增量是漏触发数的下限，不晚于窗口的触发数给出上限。下限只在延迟超出窗口（积压）时偏高，
+ *   因此一个周期内的最大下限要经下一周期所有帧的上限检验后才计入。延迟抖动只改变在途帧数，不会计为漏触发；
+ *   只用触发通道的计数与相机帧计数，与 FrameTriggerMatcher 是否锁定、关联是否正确无关。
+ * - SDK 缓存溢出或传输丢失：相机帧计数不连续，相机已曝光但帧没有送达。
+ * - 取图处理跟不上：帧到达时该通道已有超过门限的后续触发，帧在 SDK 缓存中积压。
+ *
+ * 统计发布到 "<name>_drops" 话题（FrameDropStats），本周期内出现丢帧时输出警告。
+ * 相机停止出图时仍需周期调用 Poll，使触发数继续增长、问题可见。每个相机线程各用一个实例，不需要加锁。
+ */
+class FrameDropMonitor {
+ public:
+  /**
+   * @param dev 相机对应的触发通道。
+   * @param name 相机名称。
+   * @param backlog_threshold 判定为处理跟不上的积压帧数。
+   * @param publish_period_us 统计发布周期。
+   */
+  FrameDropMonitor(TriggerDevice dev, std::string name, uint32_t backlog_threshold = 30,
+                   uint64_t publish_period_us = 1000000);
+
+  /**
+   * @brief 每收到一帧调用一次。
+   *
+   * @param frame_num 相机帧计数。
+   * @param trigger 该帧关联的触发，为空表示没有找到。
+   * @param window 该帧的触发时间范围，通常为 CaptureLatencyModel::Window 的结果。
+   */
+  void Update(uint64_t frame_num, const TriggerEvent *trigger, const TriggerWindow &window);
+
+  /**
+   * @brief 距上次发布超过一个发布周期时发布统计，Update 中已调用，没有收到帧时由取图线程调用。
+   */
+  void Poll();
+
+  FrameDropStats GetStats() const { return stats_; }
+
+ private:
+  // 触发时间不晚于 time_us 的触发数，包括已确定早于它的丢失触发
+  uint64_t CountBefore(uint64_t time_us, bool &found) const;
+  void CountMissed(uint64_t frame_num, const TriggerWindow &window);
+
+  TriggerDevice dev_;
+  std::string name_;
+  std::string topic_;
+  uint32_t backlog_threshold_;
+  uint64_t publish_period_us_;
+  FrameDropStats stats_{};
+  bool has_frame_{false};
+  uint64_t last_frame_num_{0};
+  bool has_count_{false};
+  uint64_t first_count_{0};      // 第一帧到达时该通道的触发数
+  uint64_t lost_{0};             // 已确定早于当前窗口的丢失触发数
+  uint64_t pending_lost_{0};     // 最新的丢失触发数
+  uint64_t pending_lost_us_{0};  // pending_lost_ 变化时最近一次触发的时间
+  bool has_base_{false};
+  uint64_t base_count_{0};       // 基准帧之前的触发数
+  uint64_t base_frame_num_{0};   // 基准帧的相机帧计数
+  bool has_period_{false};
+  int64_t period_lower_{0};      // 本周期内漏触发数下限的最大值
+  bool has_pending_{false};
+  int64_t pending_{0};           // 上一周期的下限，经之后每帧的上限截断
+  int64_t committed_{0};         // 已计入 missed_triggers 的漏触发数
+  uint64_t last_publish_us_{0};
+  FrameDropStats published_{};   // 上次发布时的统计，用于判断本周期是否有新的丢帧
+};
+
+}  // namespace infinite_sense
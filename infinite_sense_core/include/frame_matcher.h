@@ -0,0 +1,86 @@
+#pragma once
+#include "config.h"
+#include "trigger.h"
+#include <cstdint>
+#include <string>
+
+namespace infinite_sense {
+
+/**
+ * @brief 帧与触发关联的统计信息。
+ */
+struct FrameMatchStats {
+  uint64_t frames{0};      // 处理的帧数
+  uint64_t by_counter{0};  // 按帧计数精确关联的帧数
+  uint64_t by_time{0};     // 尚未对齐时按到达时间关联的帧数
+  uint64_t ambiguous{0};   // 按时间关联时窗口内没有或有多个触发的帧数，不参与对齐
+  uint64_t unmatched{0};   // 找不到触发的帧数
+  uint64_t mismatches{0};  // 帧计数与触发序号失配的次数
+  uint64_t locks{0};       // 建立（或重新建立）计数对齐的次数
+  int64_t offset{0};       // 当前 触发序号 - 帧计数
+  bool locked{false};      // 是否已建立计数对齐
+};
+
+/**
+ * @brief 一帧所属触发的时间范围（设备时间），由 CaptureLatencyModel::Window 给出。
+ */
+struct TriggerWindow {
+  uint64_t arrival_us{0};          // 取得图像的时间
+  uint64_t earliest_us{0};         // 按时间关联的下限：到达时间 - 最大延迟
+  uint64_t latest_us{0};           // 按时间关联的上限：到达时间 - 最小延迟
+  uint64_t locked_earliest_us{0};  // 按序号取得的触发早于该时间时视为迟到
+  uint64_t locked_latest_us{0};    // 按序号取得的触发晚于该时间时判定为失配
+};
+
+/**
+ * @class FrameTriggerMatcher
+ * @brief 用相机帧计数与触发通道的触发序号关联帧和触发。
+ *
+ * 相机缓存较多帧时，按“最近一次触发”打时间戳会错开一个或多个触发周期。未对齐时在 [earliest_us, latest_us]
+ * 内查找触发，窗口内只有一个触发时关联才是确定的；连续若干帧确定地得到相同的 触发序号 - 帧计数 差值后
+ * 锁定该差值，此后每帧直接按序号取得对应的触发。以下情况判定为失配，记录并回到按时间关联：
+ * - 按序号取得的触发晚于 locked_latest_us（比 latest_us 宽，偶尔偏快的帧不会破坏锁定）；
+ * - 连续若干帧的触发早于 locked_earliest_us，且不是积压帧被集中取出（相机漏触发，差值变大）；
+ * - 该通道有触发消息丢失（TriggerManger::GetLostTriggers 增加）。
+ * 积压帧被集中取出时延迟逐帧减少约一个触发间隔，不计为迟到，积压期间保持锁定。
+ * 每个相机线程各用一个实例，不需要加锁。
+ */
+class FrameTriggerMatcher {
+ public:
+  /**
+   * @param dev 相机对应的触发通道。
+   * @param name 日志中使用的相机名称。
+   */
+  FrameTriggerMatcher(TriggerDevice dev, std::string name);
+
+  /**
+   * @brief 为一帧查找对应的触发。
+   *
+   * @param frame_num 相机帧计数。
+   * @param window 该帧触发时间的范围。
+   * @param trigger 输出的触发事件；窗口内触发不唯一时为窗口上限前最近的触发。
+   * @return false 没有可用的触发。
+   */
+  bool Match(uint64_t frame_num, const TriggerWindow &window, TriggerEvent &trigger);
+
+  FrameMatchStats GetStats() const { return stats_; }
+
+ private:
+  void Unlock(const char *reason);
+
+  /// 锁定时检查按序号取得的触发是否迟到，返回 false 表示连续迟到的帧数已达到失配门限。
+  bool CheckLate(const TriggerWindow &window, const TriggerEvent &trigger);
+
+  TriggerDevice dev_;
+  std::string name_;
+  FrameMatchStats stats_{};
+  int64_t candidate_offset_{0};
+  int candidate_frames_{0};
+  uint64_t lost_triggers_{0};
+  int late_frames_{0};           // 连续迟到的帧数
+  bool has_last_{false};         // 锁定后是否已有上一帧
+  uint64_t last_trigger_us_{0};  // 上一帧的触发时间
+  uint64_t last_latency_us_{0};  // 上一帧的 到达时间 - 触发时间
+};
+
+}  // namespace infinite_sense
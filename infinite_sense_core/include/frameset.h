@@ -0,0 +1,125 @@
+#pragma once
+#include "raw_frame.h"
+#include "trigger.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace infinite_sense {
+
+/**
+ * @brief 帧组超时仍不完整时的处理方式。
+ */
+enum class FrameSetPolicy {
+  DROP_PARTIAL,     // 丢弃不完整的帧组
+  PUBLISH_PARTIAL,  // 帧数不少于 min_frames 时照常发布，缺失的相机为空
+};
+
+/**
+ * @brief 帧组聚合配置。
+ */
+struct FrameSetConfig {
+  std::vector<std::string> cameras;                     // 参与聚合的相机名称，帧组内按此顺序排列
+  uint64_t timeout_us{50000};                           // 收到帧组第一帧后等待其余相机的最长时间（主机时间）
+  FrameSetPolicy policy{FrameSetPolicy::DROP_PARTIAL};  // 超时仍不完整时的处理方式
+  size_t min_frames{1};                                 // PUBLISH_PARTIAL 时发布所需的最少帧数
+  size_t max_pending{8};                                // 同时等待的帧组上限，超出时按超时处理最旧的帧组
+};
+
+/**
+ * @brief 同一次触发的各相机图像。
+ *
+ * 帧以引用计数句柄保存，帧组与 RawFrameHub 的订阅者共享同一份原始帧，颜色转换结果同样共享。
+ */
+struct FrameSet {
+  uint64_t time_stamp_us{0};                            // 触发时间（同步板时间）
+  uint64_t trigger_seq{0};                              // 同步板采集节拍（"c" 字段）
+  bool complete{false};                                 // 所有相机均已到齐
+  std::vector<std::shared_ptr<const RawFrame>> frames;  // 与 FrameSetConfig::cameras 一一对应，缺失为空
+};
+
+/**
+ * @brief 帧组聚合统计。
+ */
+struct FrameSetStats {
+  uint64_t frames{0};             // 收到的帧数
+  uint64_t complete{0};           // 发布的完整帧组数
+  uint64_t partial{0};            // 超时后按部分发布的帧组数
+  uint64_t dropped{0};            // 超时或等待数超限后丢弃的不完整帧组数
+  uint64_t late{0};               // 所属帧组已结束后才到达、被丢弃的帧数
+  uint64_t duplicates{0};         // 同一帧组内同一相机重复到达的帧数（保留后到的帧）
+  uint64_t unknown{0};            // 不在配置中的相机的帧数
+  std::vector<uint64_t> missing;  // 各相机在不完整帧组中缺失的次数，与 FrameSetConfig::cameras 对应
+};
+
+using FrameSetCallback = std::function<void(const std::shared_ptr<const FrameSet> &)>;
+
+/**
+ * @class FrameSetAggregator
+ * @brief 把多个相机同一次触发的图像聚合为一个帧组发布。
+ *
+ * 各相机线程在为帧关联到触发后调用 Add，帧按触发时间归入帧组（同一条触发消息在各通道上的触发时间相同）。
+ * 所有配置的相机到齐即发布；超过 timeout_us 仍不完整的帧组按 FrameSetPolicy 发布或丢弃，并计入统计。
+ * 超时在每次 Add 时检查，链路停止时调用 Flush 结束所有等待中的帧组。
+ *
+ * 帧组通过 Subscribe 注册的回调按结束先后发布，回调在完成该帧组的相机线程中、锁外调用，应尽快返回。
+ * 帧组中的图像与回调持有的句柄同生命周期，Messenger 按字节复制消息，无法传递引用计数，因此不经由 Messenger。
+ */
+class FrameSetAggregator {
+ public:
+  explicit FrameSetAggregator(FrameSetConfig config);
+
+  FrameSetAggregator(const FrameSetAggregator &) = delete;
+  FrameSetAggregator &operator=(const FrameSetAggregator &) = delete;
+
+  /**
+   * @brief 注册帧组回调，需在相机启动前调用。
+   */
+  void Subscribe(FrameSetCallback callback);
+
+  /**
+   * @brief 加入一帧。
+   *
+   * @param name 相机名称。
+   * @param trigger 该帧对应的触发。
+   * @param frame 原始帧。
+   */
+  void Add(const std::string &name, const TriggerEvent &trigger, std::shared_ptr<const RawFrame> frame);
+
+  /**
+   * @brief 按超时处理所有等待中的帧组。
+   */
+  void Flush();
+
+  FrameSetStats GetStats() const;
+
+  const FrameSetConfig &GetConfig() const { return config_; }
+
+ private:
+  struct Pending {
+    std::shared_ptr<FrameSet> set;
+    uint64_t first_ns{0};  // 第一帧到达的主机时间
+    size_t count{0};
+  };
+
+  /// 结束一个帧组，需发布时放入 ready。调用时持有 lock_。
+  void Finish(std::map<uint64_t, Pending>::iterator it, std::vector<std::shared_ptr<const FrameSet>> &ready);
+
+  /// 结束超时的帧组。调用时持有 lock_。
+  void Expire(uint64_t now_ns, std::vector<std::shared_ptr<const FrameSet>> &ready);
+
+  void Publish(const std::vector<std::shared_ptr<const FrameSet>> &ready) const;
+
+  const FrameSetConfig config_;
+  std::vector<FrameSetCallback> callbacks_;
+  mutable std::mutex lock_;
+  std::map<uint64_t, Pending> pending_;  // 按触发时间排序
+  uint64_t last_finished_us_{0};         // 最近结束的帧组中最新的触发时间
+  FrameSetStats stats_{};
+};
+
+}  // namespace infinite_sense
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+
+namespace infinite_sense {
+
+/**
+ * @brief IMU 时间戳调理统计。
+ */
+struct ImuTimeStats {
+  uint64_t samples{0};    // 处理的样本数
+  uint64_t gaps{0};       // 检测到的丢帧次数
+  uint64_t dropped{0};    // 丢失的样本总数
+  uint64_t steps{0};      // 时间跳变（含回退）次数
+  uint64_t resets{0};     // 同步板复位次数
+  uint64_t wraps{0};      // 采集帧数回绕次数
+  double period_us{0};    // 估计的采样周期
+};
+
+/**
+ * @class ImuTimeConditioner
+ * @brief IMU 时间戳调理：根据采集帧数与时间戳检测回绕、跳变与丢帧，并可按标称采样周期平滑采样时间。
+ *
+ * 同步板复位、PTP 校正导致的时钟跳变以及链路丢包都会让 IMU 采样间隔不均匀，直接用于预积分会引入误差。
+ * 调理器在连续的样本上估计采样周期，把不连续处标记在 ImuData::time_flags 中；开启平滑后，连续样本的时间戳
+ * 由 上一帧时间 + 帧数差 * 周期 预测，再向原始时间戳缓慢收敛，跳变处直接重新对齐到原始时间戳。线程安全。
+ */
+class ImuTimeConditioner {
+ public:
+  static ImuTimeConditioner& GetInstance() {
+    static ImuTimeConditioner instance;
+    return instance;
+  }
+  ImuTimeConditioner(const ImuTimeConditioner&) = delete;
+  ImuTimeConditioner& operator=(const ImuTimeConditioner&) = delete;
+
+  /**
+   * @brief 处理一帧 IMU 数据的时间戳。
+   *
+   * @param raw_us 同步板上报的时间戳。
+   * @param counter 同步板采集帧数。
+   * @param flags 输出的 ImuTimeFlag 组合。
+   * @return 发布用的时间戳。
+   */
+  uint64_t Process(uint64_t raw_us, uint64_t counter, uint8_t& flags);
+
+  /**
+   * @brief 是否按标称采样周期平滑时间戳，默认关闭。
+   */
+  void SetSmoothing(bool enable);
+
+  /**
+   * @brief 指定标称采样频率，0 表示根据数据在线估计。
+   */
+  void SetNominalRate(double rate_hz);
+
+  ImuTimeStats GetStats() const;
+
+  /// 清除历史状态，下一帧重新对齐。
+  void Reset();
+
+ private:
+  ImuTimeConditioner() = default;
+
+  bool smoothing_{false};
+  double nominal_period_us_{0};
+  bool has_last_{false};
+  uint64_t last_raw_us_{0};
+  uint64_t last_counter_{0};
+  double last_out_us_{0};
+  double period_us_{0};
+  ImuTimeStats stats_{};
+  mutable std::mutex lock_{};
+};
+
+}  // namespace infinite_sense
@@ -4,10 +4,19 @@
 #include "messenger.h"
 #include "sensor.h"
 #include "trigger.h"
+#include "clock_estimator.h"
+#include "clock.h"
+#include "time_translator.h"
+#include "imu_time.h"
 namespace infinite_sense {
 
 class NetManager;
 class UsbManager;
+class ReplayManager;
+class RawRecorder;
+class PtpExchangeLog;
+class Ptp;
+struct SerialLatencyStats;
 class Sensor;
 class TriggerManger;
 class Messenger;
@@ -47,8 +56,9 @@ class Synchronizer {
    *
    * @param serial_dev 串口设备名称（如 "/dev/ttyUSB0"）。
    * @param serial_baud_rate 波特率（如 115200）。
+   * @param low_latency 是否启用串口低延迟模式（ASYNC_LOW_LATENCY + 阻塞批量读取）。
    */
-  void SetUsbLink(std::string serial_dev, int serial_baud_rate);
+  void SetUsbLink(std::string serial_dev, int serial_baud_rate, bool low_latency = false);
 
   /**
    * @brief 配置网络连接参数。
@@ -58,6 +68,28 @@ class Synchronizer {
    */
   void SetNetLink(std::string net_dev, unsigned int port);
 
+  /**
+   * @brief 使用录制的原始字节流代替真实设备（回放链路）。
+   *
+   * @param path RawRecorder 生成的记录文件。
+   * @param speed 回放倍速，1.0 为实时，小于等于 0 表示以最大速度回放。
+   */
+  void SetReplayLink(std::string path, double speed = 1.0);
+
+  /**
+   * @brief 把网口或串口收到的原始字节连同到达时间录制到文件，需在 Start 之前调用。
+   *
+   * @param path 记录文件路径。
+   */
+  void SetRecordPath(const std::string& path);
+
+  /**
+   * @brief 把每次时间同步交换的 t1~t4 记录到文件，供 tools/ptp_filter_eval 离线评估，需在 Start 之前调用。
+   *
+   * @param path 记录文件路径。
+   */
+  void SetPtpLogPath(const std::string& path);
+
   /**
    * @brief 使用传感器，并配置其对应的触发设备。
    *
@@ -65,7 +97,48 @@ class Synchronizer {
    */
   void UseSensor(const std::shared_ptr<Sensor>&);
 
+  /**
+   * @brief 配置 IMU 时间戳调理。
+   *
+   * @param smoothing 是否按采样周期平滑时间戳，丢帧、跳变处始终使用原始时间戳并在 time_flags 中标记。
+   * @param nominal_rate_hz IMU 标称采样频率，0 表示根据数据在线估计。
+   */
+  void SetImuTimeSmoothing(bool smoothing, double nominal_rate_hz = 0);
+
+  /**
+   * @brief 获取 IMU 时间戳调理统计（丢帧、跳变、复位次数与估计的采样周期）。
+   */
+  ImuTimeStats GetImuTimeStats() const;
+
+  /**
+   * @brief 获取串口接收延迟统计。
+   *
+   * @param stats 输出的统计结果。
+   * @return false 未使用串口连接。
+   */
+  bool GetUsbLatencyStats(SerialLatencyStats& stats) const;
+
+  /**
+   * @brief 获取主机侧持续估计的设备时钟模型（设备时间相对主机时间的偏差与漂移）。
+   *
+   * @return 未建立时间同步时 valid 为 false。
+   */
+  ClockModel GetClockModel() const;
+
+  /**
+   * @brief 获取时间同步交换的离群值过滤统计。
+   */
+  RttFilterStats GetPtpFilterStats() const;
+
+  /**
+   * @brief 获取时间同步质量快照，与 "sync_quality" 话题每秒发布的 SyncQuality 内容一致。
+   */
+  SyncQuality GetSyncQuality() const;
+
  private:
+  /// 当前链路使用的时间同步模块
+  std::shared_ptr<Ptp> ActivePtp() const;
+
   /// 网络地址
   std::string net_ip_;
 
@@ -84,6 +157,15 @@ class Synchronizer {
   /// 串口管理器
   std::shared_ptr<UsbManager> serial_manager_{nullptr};
 
+  /// 回放管理器
+  std::shared_ptr<ReplayManager> replay_manager_{nullptr};
+
+  /// 原始字节流记录器
+  std::shared_ptr<RawRecorder> recorder_{nullptr};
+
+  /// 时间同步交换记录
+  std::shared_ptr<PtpExchangeLog> ptp_log_{nullptr};
+
   /// 相机管理器
   std::shared_ptr<Sensor> sensor_manager_{nullptr};
 };
@@ -0,0 +1,97 @@
+#pragma once
+#include "config.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace infinite_sense {
+
+/// NMEA 语句输出，参数为带 "\r\n" 的完整语句，例如写入接激光雷达的串口。在 LaserManager 的输出线程中调用。
+using NmeaSink = std::function<void(const std::string &)>;
+
+/**
+ * @class LaserManager
+ * @brief 激光雷达 PPS 通道：把同步板输出给激光雷达的 PPS 脉冲发布为 LaserData，并可生成 GPRMC 授时语句。
+ *
+ * 同步板在激光雷达通道上输出秒脉冲并上报触发消息，每个脉冲发布一条 LaserData（话题为通道名称），
+ * 时间戳即脉冲的同步板时间，与相机、IMU 处于同一时间基准。需要 PPS + NMEA 授时的激光雷达，
+ * 可开启 GPRMC 生成，无需外接 GPS 授时盒。PPS + NMEA 授时的激光雷达把脉冲沿当作语句所写的整秒，因此语句时间
+ * 为整秒：该脉冲经 TimeTranslator 与 HostClock 换算得到的 UTC 时间取最近的整秒，相邻脉冲的整秒依次加一，
+ * 与换算结果相差超过 1 s 时重新取整；同一整秒记入 LaserData::utc_us，可由此换算激光雷达时间与同步板时间。
+ * 语句发布到 "<name>_nmea" 话题，并交给独立的输出线程调用 NmeaSink，串口写入不阻塞设备消息解析。
+ *
+ * 默认启用 LASER 通道（名称 "laser"），其它激光雷达通道通过 AddChannel 配置，需在链路启动前完成。
+ */
+class LaserManager {
+ public:
+  static LaserManager &GetInstance() {
+    static LaserManager instance;
+    return instance;
+  }
+  LaserManager(const LaserManager &) = delete;
+  LaserManager &operator=(const LaserManager &) = delete;
+  ~LaserManager();
+
+  /**
+   * @brief 增加一个激光雷达 PPS 通道。
+   *
+   * @param dev 触发通道，例如 LIDAR_1。
+   * @param name 发布 LaserData 的话题名称。
+   */
+  void AddChannel(TriggerDevice dev, const std::string &name);
+
+  /**
+   * @brief 开启或关闭 GPRMC 语句生成。
+   *
+   * @param enable 是否生成。
+   * @param sink 语句输出，可为空，此时只发布到 "<name>_nmea" 话题；在输出线程中调用，积压时丢弃最旧的语句。
+   */
+  void SetNmea(bool enable, NmeaSink sink = nullptr);
+
+  /**
+   * @brief 处理一条触发消息，由设备消息解析调用。
+   *
+   * @param time_us 触发时间（同步板时间）。
+   * @param mask 触发状态位掩码。
+   * @param seq 同步板采集节拍（"c" 字段）。
+   */
+  void Process(uint64_t time_us, uint64_t mask, uint64_t seq);
+
+  /**
+   * @brief 生成 GPRMC 语句，只填写时间与日期，定位字段为空。
+   *
+   * @param utc_us UTC 时间，微秒。
+   */
+  static std::string FormatGprmc(uint64_t utc_us);
+
+ private:
+  LaserManager();
+  // 输出线程：依次把语句交给 NmeaSink
+  void Write();
+
+  struct Channel {
+    TriggerDevice dev;
+    std::string name;
+    std::string nmea_topic;
+  };
+
+  std::vector<Channel> channels_{};
+  bool nmea_{false};
+  NmeaSink sink_{nullptr};
+  uint64_t last_time_us_{0};  // 上一个脉冲的同步板时间
+  uint64_t last_utc_s_{0};    // 上一个脉冲的 UTC 整秒
+  std::mutex lock_{};
+
+  std::thread writer_{};
+  std::deque<std::string> queue_{};  // 待输出的语句
+  bool stop_{false};
+  std::mutex queue_lock_{};
+  std::condition_variable queue_cv_{};
+};
+
+}  // namespace infinite_sense
@@ -0,0 +1,93 @@
+#pragma once
+#include "config.h"
+#include "frame_matcher.h"
+#include "trigger.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+namespace infinite_sense {
+
+/**
+ * @class CaptureLatencyModel
+ * @brief 单个相机从触发到取得图像（MV_CC_GetImageBuffer 返回）的延迟模型。
+ *
+ * 延迟由曝光、读出、传输（包大小、GevSCPD 包间隔）与取图排队组成，随相机配置不同而不同。
+ * 在线统计最近若干帧的延迟分布，给出一帧所属触发的时间范围（TriggerWindow）：低分位数作为延迟下限，比只减去
+ * 曝光时间更紧；高分位数作为延迟上限，窗口宽度小于触发周期时按时间关联是确定的。分位数与直方图每秒发布到
+ * "<name>_latency" 话题。延迟中位数减去曝光超过触发周期时，图像传输跟不上触发，通常是包间隔或包大小配置不当，
+ * 输出警告。
+ *
+ * 只应记录关联可靠的帧（如按帧计数锁定后的帧）。分布只由锁定后的帧学习，一次错误的锁定会被模型学到并反过来
+ * 确认，因此 FrameTriggerMatcher 只在窗口内触发唯一的帧连续一致时才锁定；超过 2 s 没有可学习的帧时丢弃已学到
+ * 的分布，回到先验范围重新对齐。每个相机线程各用一个实例，不需要加锁。
+ */
+class CaptureLatencyModel {
+ public:
+  /**
+   * @param dev 相机对应的触发通道。
+   * @param name 相机名称。
+   * @param window 参与统计的最近帧数。
+   */
+  CaptureLatencyModel(TriggerDevice dev, std::string name, size_t window = 512);
+
+  /**
+   * @brief 记录一帧的延迟。模型可用后，早于 Window 迟到下限的触发（积压后集中取出的帧）不参与统计。
+   *
+   * @param arrival_us 取得图像的时间（设备时间）。
+   * @param trigger_us 该帧对应的触发时间。
+   * @param exposure_us 该帧的曝光时间。
+   */
+  void Record(uint64_t arrival_us, uint64_t trigger_us, double exposure_us);
+
+  /// 样本数足够时模型可用。
+  bool Valid() const;
+
+  /**
+   * @brief 预测一帧所属触发的时间范围（设备时间）。
+   *
+   * 模型可用时延迟范围为 [延迟下限 - 余量, 延迟上限 + 余量]，下限不小于曝光时间；否则为 SetPriorRange 设置的
+   * 范围，默认 [曝光时间, 曝光时间 + 一个触发周期]，即假定启动时帧在一个触发周期内到达（SDK 缓存为空）。
+   * 锁定后的迟到判定再放宽半个触发周期；锁定后的上限取历史最小延迟减半个触发周期，不小于曝光时间。
+   */
+  TriggerWindow Window(uint64_t arrival_us, double exposure_us) const;
+
+  /**
+   * @brief 设置学到延迟分布前使用的延迟范围（含曝光）。
+   *
+   * 只凭到达时间无法区分延迟 L 与 L - 触发周期：传输时间可能超过一个触发周期的相机，默认范围会关联到
+   * 更新的触发。此时按链路配置给出范围，宽度应小于触发周期，否则窗口内触发不唯一，无法对齐。
+   *
+   * @param min_us 最小延迟。
+   * @param max_us 最大延迟，为 0 时恢复默认范围。
+   */
+  void SetPriorRange(double min_us, double max_us);
+
+  /// 当前窗口的延迟分布。
+  CaptureLatency GetLatency() const;
+
+  /**
+   * @brief 距上次发布超过 1 s 时发布延迟分布，Record 中已调用。
+   */
+  void Poll();
+
+ private:
+  TriggerDevice dev_;
+  std::string name_;
+  std::string topic_;
+  size_t window_;
+  std::deque<uint64_t> latencies_{};
+  double exposure_us_{0};
+  double floor_us_{0};      // 延迟下限，每隔若干帧重新计算
+  double ceil_us_{0};       // 延迟上限，与下限一起计算
+  double prior_min_us_{0};  // 学到延迟分布前使用的最小延迟
+  double prior_max_us_{0};  // 学到延迟分布前使用的最大延迟，为 0 时使用默认范围
+  double min_us_{0};        // 历史最小延迟
+  uint64_t last_record_us_{0};
+  size_t since_refresh_{0};
+  uint64_t last_publish_us_{0};
+  bool transfer_warned_{false};
+};
+
+}  // namespace infinite_sense
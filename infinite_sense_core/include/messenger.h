@@ -20,6 +20,7 @@ class Messenger {
   Messenger(const Messenger&) = delete;
   Messenger(const Messenger&&) = delete;
   Messenger& operator=(const Messenger&) = delete;
+  // 发布可在任意线程中调用：zmq 套接字不是线程安全的，话题与数据两段消息在锁内连续发送
   void Pub(const std::string& topic, const std::string& metadata);
   void PubStruct(const std::string& topic, const void* data, size_t size);
   void Sub(const std::string& topic, const std::function<void(const std::string&)>& callback);
@@ -31,6 +32,7 @@ class Messenger {
   void CleanUp();
   zmq::context_t context_{};
   zmq::socket_t publisher_{}, subscriber_{};
+  std::mutex pub_lock_{};  // 串行化 publisher_ 上的发送
   std::string endpoint_{};
   std::vector<std::thread> sub_threads_;
 };
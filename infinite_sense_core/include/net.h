@@ -1,8 +1,10 @@
 #pragma once
 #include "practical_socket.h"
+#include "recorder.h"
 
 #include <thread>
 #include <memory>
+#include <vector>
 namespace infinite_sense {
 class Ptp;
 class NetManager {
@@ -11,14 +13,22 @@ class NetManager {
   ~NetManager();
   void Start();
   void Stop();
+  const std::shared_ptr<Ptp>& GetPtp() const { return ptp_; }
+  /// 把收到的原始数据报同时写入记录器，需在 Start 之前设置。
+  void SetRecorder(const std::shared_ptr<RawRecorder>& recorder) { recorder_ = recorder; }
+
  private:
-  void Receive() const;
+  void Receive();
+  void HandlePacket(const uint8_t* data, size_t size) const;
   void TimeStampSynchronization() const;
   std::shared_ptr<UDPSocket> net_ptr_;
   std::shared_ptr<Ptp> ptp_;
+  std::shared_ptr<RawRecorder> recorder_{nullptr};
   unsigned short port_{};
   std::string target_ip_;
   std::thread rx_thread_, tx_thread_;
   bool started_{false};
+  // UDP 数据报最大 64 KB，只由接收线程使用，解析在下一次接收前完成
+  std::vector<uint8_t> rx_buffer_ = std::vector<uint8_t>(65536);
 };
 }  // namespace infinite_sense
@@ -1,22 +1,74 @@
 #pragma once
 #include "usb.h"
+#include "clock_estimator.h"
+#include "sync_monitor.h"
+#include "recorder.h"
 #include <json.h>
+#include <atomic>
+#include <chrono>
 #include <practical_socket.h>
 namespace infinite_sense {
 class Ptp {
  public:
 
-  Ptp() = default;
+  Ptp();
   void ReceivePtpData(const nlohmann::json &);
   void SendPtpData() const;
+
+  /**
+   * @brief 下一次时间同步交换前应等待的时间。
+   *
+   * 启动或检测到时钟跳变后以短间隔突发交换以快速收敛，偏差与拟合残差稳定后逐步加倍间隔，减少链路占用。
+   */
+  std::chrono::milliseconds NextSyncInterval() const;
   void SetUsbPtr(const std::shared_ptr<serial::Serial> &);
   void SetNetPtr(const std::shared_ptr<UDPSocket> &, const std::string &, unsigned short);
 
+  /**
+   * @brief 记录每次交换的原始时间戳，传入 nullptr 关闭记录。需在链路启动前设置。
+   */
+  void SetExchangeLog(const std::shared_ptr<PtpExchangeLog> &log) { exchange_log_ = log; }
+
+  /**
+   * @brief 获取主机侧估计的设备时钟模型（偏差与漂移）。
+   */
+  ClockModel GetClockModel() const { return estimator_.GetModel(); }
+
+  /**
+   * @brief 获取最小往返时延过滤的统计信息（接受/丢弃的交换数及当前门限）。
+   */
+  RttFilterStats GetFilterStats() const { return rtt_filter_.GetStats(); }
+
+  /**
+   * @brief 当前同步状态。
+   *
+   * 超过 3 个交换周期（至少 500 ms）没有收到交换时进入保持状态：同步板时钟自由运行，TimeTranslator 继续
+   * 按最后的偏差与漂移模型外推；链路恢复后的第一个交换会触发突发同步以快速收敛。保持状态只反映链路是否中断，
+   * 被最小往返时延过滤丢弃的交换同样说明链路正常；自最后一次被接受的交换起累积的漂移由 GetUncertaintyUs 体现。
+   */
+  SyncState GetSyncState() const;
+
+  /**
+   * @brief 设备时间相对主机时钟的估计不确定度（微秒）：拟合残差加上自上次同步以来漂移误差的累积。
+   */
+  double GetUncertaintyUs() const;
+
+  /**
+   * @brief 获取当前的同步质量快照（偏差、漂移、往返时延分位数、丢弃计数与滚动直方图）。
+   */
+  SyncQuality GetSyncQuality() const;
+
+  /**
+   * @brief 距上次发布超过 1 s 时，把同步质量快照发布到 "sync_quality" 话题，由时间同步线程周期调用。
+   */
+  void PublishSyncQuality();
+
  private:
   void HandleTimeSyncRequest(const nlohmann::json &data);
   void HandleTimeSyncResponse(const nlohmann::json &data);
   static uint64_t GetCurrentTimeUs();
   void SendJson(const nlohmann::json &data) const;
+  void UpdateSchedule(int64_t offset);
 
   std::shared_ptr<serial::Serial> serial_ptr_{nullptr};
   std::shared_ptr<UDPSocket> net_ptr_{nullptr};
@@ -25,6 +77,17 @@ class Ptp {
   uint64_t time_t1_{0};
   uint64_t time_t2_{0};
   bool updated_t1_t2_{false};
+  uint64_t a_recv_ns_{0};
+  std::shared_ptr<PtpExchangeLog> exchange_log_{nullptr};
+  ClockEstimator estimator_{};
+  MinRttFilter rtt_filter_{};
+  SyncMonitor monitor_{};
+  uint64_t last_publish_us_{0};
+  SyncState published_state_{SYNC_NONE};
+  std::atomic<uint64_t> last_sync_us_{0};
+  std::atomic<uint64_t> holdover_after_us_{0};
+  std::atomic<int> burst_remaining_{0};
+  std::atomic<int64_t> interval_ms_{0};
 };
 
 }  // namespace infinite_sense
\ No newline at end of file
@@ -0,0 +1,146 @@
+#pragma once
+#include "config.h"
+#include "demosaic.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace infinite_sense {
+
+/**
+ * @brief 相机输出的原始像素格式。
+ */
+enum class PixelFormat {
+  MONO8,  // 8 位灰度
+  BGR8,   // 8 位 BGR 交织
+  RGB8,   // 8 位 RGB 交织
+  BAYER,  // Bayer 原始数据，排列与位深见 RawFormat
+};
+
+/**
+ * @brief 原始图像的格式信息。
+ */
+struct RawFormat {
+  PixelFormat pixel{PixelFormat::BAYER};     // 像素格式
+  int width{0};                              // 宽度（像素）
+  int height{0};                             // 高度（像素）
+  size_t stride{0};                          // 每行字节数
+  BayerPattern pattern{BayerPattern::RGGB};  // Bayer 排列，仅 BAYER 有效
+  int bit_depth{8};                          // Bayer 位深 8/10/12，仅 BAYER 有效
+  bool packed{false};                        // Bayer 10/12 位打包格式，仅 BAYER 有效
+};
+
+/**
+ * @brief 原始帧的格式信息，相机每帧发布到 Messenger 的 "<name>_raw" 话题，不含图像数据。
+ */
+struct RawFrameInfo {
+  uint64_t time_stamp_us;  // 帧时间戳（同步板时间），triggered 为 false 时为 0
+  bool triggered;          // 是否关联到触发，未关联的帧没有可用的时间戳
+  uint64_t frame_num;      // 相机帧计数
+  size_t size;             // 原始数据字节数
+  RawFormat format;        // 原始图像格式
+  std::string name;        // 相机名称
+};
+
+/**
+ * @class RawFrame
+ * @brief 相机发布的原始帧，颜色转换在首次请求时进行并缓存在帧上。
+ *
+ * 相机只拷贝一次原始数据（Bayer 8 位为 BGR 的 1/3），不再在取图线程中转换。Bgr()、Gray() 在第一个请求
+ * 该格式的消费者线程中转换一次，之后的消费者直接取缓存结果；没有消费者请求时不做任何转换。
+ * 帧以 std::shared_ptr<const RawFrame> 共享，所有成员函数均可在多个线程中同时调用。
+ */
+class RawFrame {
+ public:
+  /**
+   * @param time_stamp_us 帧时间戳（同步板时间）。
+   * @param triggered 是否关联到触发，为 false 时 time_stamp_us 不可用。
+   * @param name 相机名称。
+   * @param format 原始图像格式。
+   * @param data 原始数据，构造时拷贝。
+   * @param size 原始数据字节数，不足 stride * height 时 Bgr()、Gray() 返回空图像。
+   */
+  RawFrame(uint64_t time_stamp_us, bool triggered, std::string name, const RawFormat &format, const uint8_t *data,
+           size_t size);
+  RawFrame(const RawFrame &) = delete;
+  RawFrame &operator=(const RawFrame &) = delete;
+
+  uint64_t TimeStampUs() const { return time_stamp_us_; }
+  /// 是否关联到触发。关联前（FrameTriggerMatcher 未对齐且窗口内没有唯一的触发）的帧为 false，时间戳为 0。
+  bool Triggered() const { return triggered_; }
+  const std::string &Name() const { return name_; }
+  const RawFormat &Format() const { return format_; }
+  const uint8_t *Data() const { return data_.data(); }
+  size_t Size() const { return data_.size(); }
+
+  /**
+   * @brief 8 位 BGR 图像，首次调用时转换。
+   * @return 格式不支持或数据不完整时为空图像。
+   */
+  const GMat &Bgr() const;
+
+  /**
+   * @brief 8 位灰度图像，首次调用时转换。Bayer 数据直接转为灰度，不经过整帧 BGR。
+   * @return 格式不支持或数据不完整时为空图像。
+   */
+  const GMat &Gray() const;
+
+ private:
+  bool Valid() const;
+  BayerImage ToBayerImage() const;
+
+  uint64_t time_stamp_us_;
+  bool triggered_;
+  std::string name_;
+  RawFormat format_;
+  std::vector<uint8_t> data_;
+  mutable std::once_flag bgr_once_;
+  mutable std::once_flag gray_once_;
+  mutable GMat bgr_;
+  mutable GMat gray_;
+};
+
+using RawFrameCallback = std::function<void(const std::shared_ptr<const RawFrame> &)>;
+
+/**
+ * @class RawFrameHub
+ * @brief 原始帧的进程内分发。
+ *
+ * Messenger 按字节拷贝消息，无法传递引用计数的帧，原始帧因此通过回调分发。回调在相机取图线程中、锁外调用，
+ * 应尽快返回；需要转换或耗时处理时保留 shared_ptr 交给自己的线程。相机可用 HasSubscribers 判断是否需要拷贝原始帧。
+ */
+class RawFrameHub {
+ public:
+  static RawFrameHub &GetInstance() {
+    static RawFrameHub instance;
+    return instance;
+  }
+  RawFrameHub(const RawFrameHub &) = delete;
+  RawFrameHub &operator=(const RawFrameHub &) = delete;
+
+  /**
+   * @brief 订阅一个相机的原始帧。
+   *
+   * @param name 相机名称。
+   * @param callback 每帧调用一次。
+   */
+  void Subscribe(const std::string &name, RawFrameCallback callback);
+
+  /// 该相机是否有订阅者。
+  bool HasSubscribers(const std::string &name) const;
+
+  /// 发布一帧，按 RawFrame::Name() 分发。
+  void Publish(const std::shared_ptr<const RawFrame> &frame) const;
+
+ private:
+  RawFrameHub() = default;
+
+  std::unordered_map<std::string, std::vector<RawFrameCallback>> callbacks_{};
+  mutable std::mutex lock_{};
+};
+
+}  // namespace infinite_sense
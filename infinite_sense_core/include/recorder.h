@@ -0,0 +1,116 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+namespace infinite_sense {
+
+/**
+ * @brief 原始字节流的来源。
+ */
+enum class RawSource : uint8_t {
+  NET = 0,  // UDP 数据报（一条记录对应一个数据报）
+  USB = 1,  // 串口字节流（一条记录对应一次读取）
+};
+
+/**
+ * @brief 原始记录文件中的一条记录头，紧跟 length 字节的原始数据。
+ *
+ * 文件格式：8 字节魔数 "ISRAW001"，之后为连续的 [RawRecordHeader][data]，字段均为小端序。
+ */
+#pragma pack(push, 1)
+struct RawRecordHeader {
+  uint64_t host_time_ns;  // 数据到达主机的时间（HostClock 单调时钟）
+  uint8_t source;         // RawSource
+  uint32_t length;        // 原始数据长度
+};
+#pragma pack(pop)
+
+constexpr char k_raw_record_magic[8] = {'I', 'S', 'R', 'A', 'W', '0', '0', '1'};
+
+/**
+ * @brief 一次完整 PTP 交换的原始记录，时间均为 HostClock 单调时钟或同步板时钟。
+ *
+ * 文件格式：8 字节魔数 "ISPTP001"，之后为连续的 PtpExchangeRecord，字段均为小端序。
+ */
+#pragma pack(push, 1)
+struct PtpExchangeRecord {
+  uint64_t t1_us;         // 主机发送请求的时间
+  uint64_t t2_us;         // 同步板收到请求的时间
+  uint64_t t3_us;         // 同步板发送 b 消息的时间
+  uint64_t t4_us;         // 主机收到 b 消息的时间
+  uint64_t a_recv_ns;     // 主机收到 a 应答的时间
+  uint64_t b_recv_ns;     // 主机收到 b 消息的时间
+  int64_t correction_us;  // 本次下发给同步板的校正量，交换被丢弃时为 0
+  uint8_t accepted;       // 是否通过最小往返时延过滤
+};
+#pragma pack(pop)
+
+constexpr char k_ptp_log_magic[8] = {'I', 'S', 'P', 'T', 'P', '0', '0', '1'};
+
+/**
+ * @class RawRecorder
+ * @brief 把网口/串口收到的原始字节连同到达时间写入紧凑的二进制日志，用于现场问题复现。
+ *
+ * 写入在接收线程中同步完成，只做一次到 stdio 缓冲区的拷贝，多个接收线程可共用同一个记录器。
+ */
+class RawRecorder {
+ public:
+  explicit RawRecorder(const std::string& path);
+  ~RawRecorder();
+  RawRecorder(const RawRecorder&) = delete;
+  RawRecorder& operator=(const RawRecorder&) = delete;
+
+  bool IsOpen() const { return file_ != nullptr; }
+
+  /**
+   * @brief 追加一条记录。
+   *
+   * @param source 数据来源。
+   * @param host_time_ns 到达主机的时间。
+   * @param data 原始数据。
+   * @param size 数据长度。
+   */
+  void Write(RawSource source, uint64_t host_time_ns, const void* data, size_t size);
+
+  /// 把缓冲区中的数据写入文件。
+  void Flush();
+
+  uint64_t RecordCount() const { return records_; }
+
+ private:
+  std::FILE* file_{nullptr};
+  std::mutex lock_{};
+  std::atomic<uint64_t> records_{0};
+};
+
+/**
+ * @class PtpExchangeLog
+ * @brief 记录每次 PTP 交换的 t1~t4 与主机接收时间，供 tools/ptp_filter_eval 离线评估同步滤波器。
+ */
+class PtpExchangeLog {
+ public:
+  explicit PtpExchangeLog(const std::string& path);
+  ~PtpExchangeLog();
+  PtpExchangeLog(const PtpExchangeLog&) = delete;
+  PtpExchangeLog& operator=(const PtpExchangeLog&) = delete;
+
+  bool IsOpen() const { return file_ != nullptr; }
+
+  /// 追加一条交换记录。
+  void Write(const PtpExchangeRecord& record);
+
+  /// 把缓冲区中的数据写入文件。
+  void Flush();
+
+  uint64_t RecordCount() const { return records_; }
+
+ private:
+  std::FILE* file_{nullptr};
+  std::mutex lock_{};
+  std::atomic<uint64_t> records_{0};
+};
+
+}  // namespace infinite_sense
@@ -0,0 +1,49 @@
+#pragma once
+#include "recorder.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace infinite_sense {
+class Ptp;
+
+/**
+ * @class ReplayManager
+ * @brief 回放 RawRecorder 录制的原始字节流，走与 NetManager/UsbManager 相同的解析与分发路径。
+ *
+ * 可按录制时的节奏（乘以倍速）回放，也可以不等待、以最大速度回放，用于无硬件的性能分析与回归测试。
+ * 时间同步报文与链路一样先交给 Ptp：最小往返时延过滤、时钟估计、保持状态与 TimeTranslator 照常更新，
+ * 同步质量照常发布，只是 Ptp 没有链路，应答不会发送。Ptp 以回放时的主机时钟作为 t4，
+ * 因此只有按录制节奏回放时时钟模型才有意义；以最大速度回放时同步状态不可信。
+ */
+class ReplayManager {
+ public:
+  /**
+   * @param path 原始记录文件路径。
+   * @param speed 回放倍速，1.0 为实时，小于等于 0 表示以最大速度回放。
+   */
+  explicit ReplayManager(std::string path, double speed = 1.0);
+  ~ReplayManager();
+  void Start();
+  void Stop();
+
+  /// 回放是否已读到文件末尾。
+  bool Finished() const { return finished_; }
+
+  /// 回放使用的 Ptp，可查询时钟模型与同步质量。
+  const std::shared_ptr<Ptp>& GetPtp() const { return ptp_; }
+
+ private:
+  void Replay();
+  void HandleMessage(const char* data, size_t size) const;
+  std::string path_;
+  double speed_{1.0};
+  std::shared_ptr<Ptp> ptp_;
+  std::thread replay_thread_;
+  std::atomic<bool> started_{false};
+  std::atomic<bool> finished_{false};
+};
+
+}  // namespace infinite_sense
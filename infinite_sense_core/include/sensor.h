@@ -1,9 +1,11 @@
 #pragma once
+#include <memory>
 #include <thread>
 #include <vector>
 #include "messenger.h"
 #include "trigger.h"
 namespace infinite_sense {
+class FrameSetAggregator;
 class Sensor {
  public:
   Sensor();
@@ -19,6 +21,8 @@ class Sensor {
   void Enable() { is_running = true; }
   void Disable() { is_running = false; }
   void SetParams(const std::map<std::string, TriggerDevice> &params_in) { params = params_in; };
+  /// 把关联到触发的帧交给多相机帧组聚合器，需在 Start 之前调用。
+  void SetFrameSet(const std::shared_ptr<FrameSetAggregator> &frameset_in) { frameset = frameset_in; }
 
  private:
   virtual void Receive(void *, const std::string &) = 0;
@@ -27,6 +31,7 @@ class Sensor {
   bool is_running{false};
   std::vector<std::thread> cam_threads{};
   std::map<std::string, TriggerDevice> params{};
+  std::shared_ptr<FrameSetAggregator> frameset{nullptr};
 };
 
 }  // namespace infinite_sense
@@ -0,0 +1,55 @@
+#pragma once
+#include "config.h"
+#include "clock_estimator.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace infinite_sense {
+
+/**
+ * @class SyncMonitor
+ * @brief 时间同步质量统计：保存最近若干次 PTP 交换的往返时延与偏差，生成分位数与滚动直方图。
+ *
+ * 被过滤器丢弃的交换只计入往返时延统计，不计入偏差统计。线程安全。
+ */
+class SyncMonitor {
+ public:
+  /**
+   * @param window 参与统计的最近交换次数。
+   */
+  explicit SyncMonitor(size_t window = 256);
+
+  /**
+   * @brief 记录一次完整的交换。
+   *
+   * @param delay_us 单程延迟（往返时延的一半）。
+   * @param offset_us 测得的 设备时间 - 主机时间。
+   * @param accepted 是否通过最小往返时延过滤。
+   */
+  void Record(int64_t delay_us, int64_t offset_us, bool accepted);
+
+  /**
+   * @brief 结合时钟模型与过滤统计生成当前的同步质量快照。
+   *
+   * @param now_us 快照时刻（主机单调时钟）。
+   */
+  SyncQuality Snapshot(uint64_t now_us, const ClockModel& model, const RttFilterStats& filter) const;
+
+  void Reset();
+
+ private:
+  struct Exchange {
+    int64_t rtt_us;
+    int64_t offset_us;
+    bool accepted;
+  };
+
+  size_t window_;
+  std::deque<Exchange> exchanges_{};
+  int64_t last_offset_us_{0};
+  mutable std::mutex lock_{};
+};
+
+}  // namespace infinite_sense
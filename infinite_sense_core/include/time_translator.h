@@ -0,0 +1,79 @@
+#pragma once
+#include "clock_estimator.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace infinite_sense {
+
+/**
+ * @class TimeTranslator
+ * @brief 设备时间与主机单调时钟（HostClock）之间的换算服务。
+ *
+ * 由 Ptp 在每次接受交换后用时钟模型更新，读取端使用序列锁，不加锁、不分配内存，可在任意线程以任意频率调用。
+ * 同步板时钟跟随主机单调时钟，模型尚未建立（例如回放链路）时按偏差为 0 换算。
+ */
+class TimeTranslator {
+ public:
+  static TimeTranslator& GetInstance() {
+    static TimeTranslator instance;
+    return instance;
+  }
+  TimeTranslator(const TimeTranslator&) = delete;
+  TimeTranslator& operator=(const TimeTranslator&) = delete;
+
+  /**
+   * @brief 设备时间戳（ImuData::time_stamp_us、触发时间、GPS pps 等）换算为主机单调时钟，纳秒。
+   */
+  uint64_t ToHostTime(const uint64_t device_us) const {
+    const double offset_us = OffsetAt(device_us);
+    return device_us * 1000 - static_cast<int64_t>(offset_us * 1000.0);
+  }
+
+  /**
+   * @brief 主机单调时钟（纳秒）换算为设备时间，微秒。
+   */
+  uint64_t ToDeviceTime(const uint64_t host_ns) const {
+    const uint64_t host_us = host_ns / 1000;
+    return host_us + static_cast<int64_t>(OffsetAt(host_us));
+  }
+
+  /// 模型是否已由时间同步建立。
+  bool Valid() const { return valid_.load(std::memory_order_relaxed); }
+
+  /// 用最新的时钟模型更新换算参数。
+  void Update(const ClockModel& model);
+
+  /// 清除模型，回到偏差为 0 的换算。
+  void Reset();
+
+ private:
+  TimeTranslator() = default;
+
+  /// 模型在 time_us 处的 设备时间 - 主机时间。两个时钟相差仅为微秒级，用设备时间或主机时间求值差别可忽略。
+  double OffsetAt(const uint64_t time_us) const {
+    uint32_t begin, end;
+    uint64_t ref_us;
+    double offset_us, skew_ppm;
+    do {
+      begin = sequence_.load(std::memory_order_acquire);
+      ref_us = ref_host_us_.load(std::memory_order_relaxed);
+      offset_us = offset_us_.load(std::memory_order_relaxed);
+      skew_ppm = skew_ppm_.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      end = sequence_.load(std::memory_order_relaxed);
+    } while ((begin & 1) != 0 || begin != end);
+    return offset_us + skew_ppm * 1e-6 * static_cast<double>(static_cast<int64_t>(time_us - ref_us));
+  }
+
+  void Store(uint64_t ref_host_us, double offset_us, double skew_ppm);
+
+  std::atomic<uint32_t> sequence_{0};
+  std::atomic<uint64_t> ref_host_us_{0};
+  std::atomic<double> offset_us_{0};
+  std::atomic<double> skew_ppm_{0};
+  std::atomic<bool> valid_{false};
+  std::mutex write_lock_{};
+};
+
+}  // namespace infinite_sense
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
 #include <mutex>
-#include <map>
+#include <vector>
 
 #include "infinite_sense.h"
 namespace infinite_sense {
@@ -10,10 +14,20 @@ namespace infinite_sense {
  * @brief 宏定义：设置所有设备的最新触发状态。
  *
  * @param timestamp 触发时间戳。
- * @param status 触发状态位掩码（每一位对应一个设备）。
+ * @param status 触发状态位掩码（每一位对应一个通道）。
  */
 #define SET_LAST_TRIGGER_STATUS(timestamp, status) TriggerManger::GetInstance().SetLastTriggerStatus(timestamp, status)
 
+/**
+ * @brief 宏定义：设置所有设备的最新触发状态，并记录同步板的采集节拍。
+ *
+ * @param timestamp 触发时间戳。
+ * @param status 触发状态位掩码（每一位对应一个设备）。
+ * @param seq 同步板上报的采集节拍（"c" 字段）。
+ */
+#define SET_TRIGGER_STATUS(timestamp, status, seq) \
+  TriggerManger::GetInstance().SetLastTriggerStatus(timestamp, status, seq)
+
 /**
  * @brief 宏定义：获取指定设备的最新触发状态时间。
  *
@@ -22,12 +36,153 @@ namespace infinite_sense {
  */
 #define GET_LAST_TRIGGER_STATUS(device, timestamp) TriggerManger::GetInstance().GetLastTriggerStatus(device, timestamp)
 
+#ifndef INFINITE_SENSE_MAX_TRIGGER_CHANNELS
+#define INFINITE_SENSE_MAX_TRIGGER_CHANNELS 32
+#endif
+
+/// 触发通道数量（状态位掩码的位数），由 CMake 变量 INFINITE_SENSE_MAX_TRIGGER_CHANNELS 配置
+constexpr size_t k_trigger_channel_count = INFINITE_SENSE_MAX_TRIGGER_CHANNELS;
+static_assert(k_trigger_channel_count > 0 && k_trigger_channel_count <= 64, "trigger mask is carried in 64 bits");
+
+/// 触发状态位掩码，每一位对应一个触发通道
+using TriggerMask = std::bitset<k_trigger_channel_count>;
+
+/**
+ * @brief 一次触发事件。
+ */
+struct TriggerEvent {
+  uint64_t time_us{0};  // 同步板触发时间
+  uint64_t seq{0};      // 同步板采集节拍（"c" 字段），各类消息共用，不是逐包递增的序号
+  uint64_t host_ns{0};  // 主机收到触发消息的时间（HostClock 单调时钟）
+  uint64_t index{0};    // 该通道的触发序号，按到达顺序从 0 计数，由 TriggerHistory 填写
+};
+
+/**
+ * @brief 一条同步板触发消息，发布到 "trigger" 话题。
+ *
+ * 同一条消息中同时触发的所有通道合并发布，订阅者一次即可看到全部通道。index 只保存置位通道的触发序号，
+ * 按通道序号从小到大排列，发布的长度为 Size()，订阅者只能访问前 count 个 index。
+ */
+struct TriggerMessage {
+  uint64_t time_stamp_us;                   // 同步板触发时间
+  uint64_t host_ns;                         // 主机收到触发消息的时间（HostClock 单调时钟）
+  uint64_t seq;                             // 同步板采集节拍（"c" 字段）
+  uint64_t mask;                            // 触发状态位掩码
+  uint32_t count;                           // 触发的通道数
+  uint64_t index[k_trigger_channel_count];  // 各触发通道的 TriggerEvent::index
+
+  /// 消息有效长度。
+  size_t Size() const { return offsetof(TriggerMessage, index) + count * sizeof(uint64_t); }
+
+  /// 取出指定通道在本次触发中的触发序号。
+  bool ChannelIndex(const TriggerDevice dev, uint64_t &channel_index) const {
+    const auto bit = static_cast<size_t>(dev);
+    if (bit >= k_trigger_channel_count || ((mask >> bit) & 1) == 0) {
+      return false;
+    }
+    channel_index = index[std::bitset<64>(mask & ((uint64_t{1} << bit) - 1)).count()];
+    return true;
+  }
+};
+
+/**
+ * @class TriggerHistory
+ * @brief 单个设备最近触发事件的定长环形缓冲区，按到达顺序保存，支持按计数、按时间与按区间查询。
+ *
+ * 同时由触发间隔估计该通道的标称周期：间隔明显长于标称周期时，说明中间的触发消息丢失，按间隔折算丢失数。
+ * 长间隔在下一个正常间隔到达后才计为丢失，丢失数因此晚一次触发更新；连续若干个长间隔彼此一致时判定为
+ * 同步板降低了触发频率，以这些间隔重新估计周期，不计为丢失。
+ * 单写者序列锁：写入只有一个线程（由 TriggerManger 保证），读取不加锁，读到写入中途的数据时重试。
+ */
+class TriggerHistory {
+ public:
+  static constexpr size_t k_capacity = 256;
+
+  /// 追加一次触发并返回分配的通道内序号，缓冲区满时覆盖最旧的事件。只允许一个线程写入。
+  uint64_t Push(const TriggerEvent &event);
+
+  /// 最近一次触发。
+  bool Latest(TriggerEvent &event) const;
+
+  /// 按同步板采集节拍查找。
+  bool FindBySeq(uint64_t seq, TriggerEvent &event) const;
+
+  /// 按通道内触发序号查找，O(1)。
+  bool FindByIndex(uint64_t index, TriggerEvent &event) const;
+
+  /// 查找触发时间不晚于 time_us 的最近一次触发。
+  bool FindBefore(uint64_t time_us, TriggerEvent &event) const;
+
+  /// 取出触发时间位于 [begin_us, end_us] 内的所有触发，按时间先后排列。
+  void FindRange(uint64_t begin_us, uint64_t end_us, std::vector<TriggerEvent> &events) const;
+
+  size_t Size() const { return size_.load(std::memory_order_relaxed); }
+
+  /// 标称触发周期（最近若干次触发间隔的最小值，微秒），触发少于两次时为 0。
+  uint64_t Period() const { return period_us_.load(std::memory_order_relaxed); }
+
+  /// 累计丢失的触发数。
+  uint64_t Lost() const { return lost_.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr size_t k_period_window = 16;
+  // 连续这么多个彼此一致的长间隔判定为触发频率降低
+  static constexpr size_t k_rate_change_intervals = 3;
+
+  void AddInterval(uint64_t interval);
+  void CountLost(uint64_t period);
+
+  struct Slot {
+    std::atomic<uint64_t> time_us{0};
+    std::atomic<uint64_t> seq{0};
+    std::atomic<uint64_t> host_ns{0};
+    std::atomic<uint64_t> index{0};
+  };
+
+  /// 第 i 新的事件（0 为最新）。
+  TriggerEvent Recent(size_t head, size_t i) const;
+
+  /// 在序列锁保护下执行只读访问，期间发生写入则重试。
+  template <typename Func>
+  void Read(Func &&func) const {
+    for (;;) {
+      const uint32_t begin = sequence_.load(std::memory_order_acquire);
+      if ((begin & 1) != 0) {
+        continue;
+      }
+      func(head_.load(std::memory_order_relaxed), size_.load(std::memory_order_relaxed));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence_.load(std::memory_order_relaxed) == begin) {
+        return;
+      }
+    }
+  }
+
+  std::array<Slot, k_capacity> slots_{};
+  std::atomic<uint32_t> sequence_{0};
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> size_{0};
+  uint64_t next_index_{0};
+  std::array<uint64_t, k_period_window> intervals_{};  // 最近的触发间隔，只由写线程访问
+  size_t interval_count_{0};
+  uint64_t last_time_us_{0};
+  std::atomic<uint64_t> period_us_{0};
+  std::atomic<uint64_t> lost_{0};
+  std::array<uint64_t, k_rate_change_intervals> long_intervals_{};  // 尚未判定的长间隔，只由写线程访问
+  size_t long_count_{0};
+};
+
 /**
  * @class TriggerManger
  * @brief 管理各传感器或设备的触发状态，并通过消息机制发布状态信息。
  *
  * 使用单例模式管理系统中所有的触发设备。支持位掩码形式更新所有设备的状态，
- * 并可查询特定设备的最后一次有效触发时间。
+ * 并可查询特定设备的最后一次有效触发时间。每个设备保存最近 TriggerHistory::k_capacity 次触发，
+ * 图像等数据晚于下一次触发才到达时，仍可按计数或时间关联到正确的触发。
+ *
+ * 状态按设备存放在定长数组中，查询全部无锁；写入只在更新数组时互斥，状态发布在锁外进行。
+ * 每条触发消息合并发布为一条 TriggerMessage；按通道的 "<name>_trigger" 话题由它派生，默认关闭，可通过 SetChannelTopics
+ * 开启（每条触发消息随置位通道数增加为 N+1 条）。
  */
 class TriggerManger {
  public:
@@ -48,9 +203,26 @@ class TriggerManger {
    * @brief 设置所有设备的最新触发状态。
    *
    * @param time 当前触发的时间戳。
-   * @param status 状态掩码，每一位表示一个设备是否触发。
+   * @param status 状态掩码，每一位表示一个通道是否触发。
+   * @param seq 同步板上报的采集节拍。
    */
-  void SetLastTriggerStatus(const uint64_t &time, const uint8_t &status);
+  void SetLastTriggerStatus(const uint64_t &time, const TriggerMask &status, uint64_t seq = 0);
+
+  /**
+   * @brief 设置通道名称，状态发布到 "<name>_trigger" 话题。需在链路启动前调用。
+   *
+   * 默认名称见 trigger.cpp 中的表，表外的通道默认为 "channel_<序号>"。
+   */
+  void SetChannelName(TriggerDevice dev, const std::string &name);
+
+  /// 通道状态发布的话题名。
+  const std::string &GetChannelTopic(TriggerDevice dev) const;
+
+  /**
+   * @brief 是否同时按通道发布 "<name>_trigger" 话题，默认关闭。订阅或监听按通道话题时开启，每条触发消息
+   * 多发布置位通道数条消息。
+   */
+  void SetChannelTopics(bool enable) { channel_topics_.store(enable, std::memory_order_relaxed); }
 
   /**
    * @brief 获取指定设备的最后一次触发状态及时间。
@@ -60,28 +232,51 @@ class TriggerManger {
    * @return true 如果该设备有有效的触发状态。
    * @return false 如果该设备无记录。
    */
-  bool GetLastTriggerStatus(TriggerDevice dev, uint64_t &time);
+  bool GetLastTriggerStatus(TriggerDevice dev, uint64_t &time) const;
 
- private:
   /**
-   * @brief 从位掩码中获取对应设备的状态。
+   * @brief 获取指定设备最近一次触发，其 index + 1 即该通道累计的触发数。
+   */
+  bool GetLatestTrigger(TriggerDevice dev, TriggerEvent &event) const;
+
+  /**
+   * @brief 按同步板采集节拍查找指定设备的触发。
    *
-   * @param data 状态字节。
-   * @param index 目标设备在位掩码中的索引。
-   * @return true 对应位置为1，表示已触发。
-   * @return false 对应位置为0，表示未触发。
+   * @return false 该节拍不在历史记录中（过旧或该设备未在此次触发）。
+   */
+  bool GetTriggerBySeq(TriggerDevice dev, uint64_t seq, TriggerEvent &event) const;
+
+  /**
+   * @brief 按通道内触发序号（TriggerEvent::index）查找指定设备的触发。
    */
-  static bool GetBool(const uint8_t data, const int index) { return (data >> index) & 1; }
+  bool GetTriggerByIndex(TriggerDevice dev, uint64_t index, TriggerEvent &event) const;
 
   /**
-   * @brief 更新设备状态，并发布触发信息。
+   * @brief 指定设备的标称触发周期（微秒），由最近的触发间隔得到，触发少于两次时为 0。
+   */
+  uint64_t GetTriggerPeriod(TriggerDevice dev) const;
+
+  /**
+   * @brief 指定设备累计丢失的触发消息数，由触发间隔相对标称周期推断。
    *
-   * @param dev 目标设备。
-   * @param bit_index 设备对应的位掩码索引。
-   * @param time 触发时间戳。
+   * 同步板消息中的 "c" 是各类消息共用的采集节拍，不是逐包递增的序号，不能用来判断丢包。丢包后该通道的
+   * 触发序号少于实际触发数，按序号关联的数据需要重新对齐。
+   */
+  uint64_t GetLostTriggers(TriggerDevice dev) const;
+
+  /**
+   * @brief 查找指定设备触发时间不晚于 time_us 的最近一次触发。
+   *
+   * 数据到达主机时，可用 TimeTranslator::ToDeviceTime 把到达时间换算到设备时间，再减去最小传输延迟后查询。
    */
-  void UpdateAndPublishDevice(TriggerDevice dev, int bit_index, uint64_t time);
+  bool GetTriggerBefore(TriggerDevice dev, uint64_t time_us, TriggerEvent &event) const;
 
+  /**
+   * @brief 取出指定设备触发时间位于 [begin_us, end_us] 内的所有触发。
+   */
+  std::vector<TriggerEvent> GetTriggersInRange(TriggerDevice dev, uint64_t begin_us, uint64_t end_us) const;
+
+ private:
   /**
    * @brief 发布指定设备的状态信息。
    *
@@ -89,12 +284,13 @@ class TriggerManger {
    * @param time 触发时间戳。
    * @param status 当前触发状态。
    */
-  static void PublishDeviceStatus(TriggerDevice dev, uint64_t time, bool status);
+  void PublishDeviceStatus(TriggerDevice dev, uint64_t time, bool status) const;
   TriggerManger();
   ~TriggerManger() = default;
-  uint8_t status_{0};
-  std::mutex lock_{};
-  std::map<TriggerDevice, std::tuple<bool, uint64_t>> status_map_{};
+  std::mutex write_lock_{};
+  std::atomic<bool> channel_topics_{false};
+  std::array<TriggerHistory, k_trigger_channel_count> histories_{};
+  std::array<std::string, k_trigger_channel_count> topics_{};
 };
 
 }  // namespace infinite_sense
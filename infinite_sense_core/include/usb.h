@@ -1,24 +1,64 @@
 #pragma once
 #include "usb.h"
 #include "serial.h"
+#include "recorder.h"
+#include <atomic>
 #include <thread>
 #include <memory>
 
 namespace infinite_sense {
 class Ptp;
+
+/**
+ * @brief 串口接收延迟统计（仅低延迟模式下统计）。
+ *
+ * mean_handle_latency_us 为实测值；estimated_batch_latency_us 只是由波特率与每批字节数推算的模型估计
+ * （一批中的字节平均要等待后续字节到齐才被读出），并非测量结果，不应与实测值直接比较或用于告警。
+ */
+struct SerialLatencyStats {
+  uint64_t bytes{0};                     // 累计接收字节数
+  uint64_t reads{0};                     // 累计读取批次（每次唤醒读取一批）
+  uint64_t max_chunk{0};                 // 单批最大字节数
+  double byte_time_us{0};                // 单字节线上传输时间（8N1）
+  double estimated_batch_latency_us{0};  // 驱动攒批带来的每字节平均延迟（按波特率与批大小推算，非实测）
+  double mean_handle_latency_us{0};      // 从唤醒到该批消息分发完成的每字节平均耗时（实测）
+};
+
 class UsbManager {
  public:
-  explicit UsbManager(std::string , int);
+  /**
+   * @param port 串口设备名称
+   * @param baud_rate 波特率
+   * @param low_latency 低延迟模式：设置 ASYNC_LOW_LATENCY，阻塞等待数据并按批读取
+   */
+  explicit UsbManager(std::string, int, bool low_latency = false);
   ~UsbManager();
   void Start();
   void Stop();
+  const std::shared_ptr<Ptp>& GetPtp() const { return ptp_; }
+  SerialLatencyStats GetLatencyStats() const;
+  /// 把收到的原始字节同时写入记录器，需在 Start 之前设置。
+  void SetRecorder(const std::shared_ptr<RawRecorder>& recorder) { recorder_ = recorder; }
+
  private:
-  void Receive() const;
+  void Receive();
+  void ReceiveLowLatency();
+  void Record(const void* data, size_t size) const;
+  void HandleLine(const char* data, size_t size) const;
   void TimeStampSynchronization() const;
   std::string port_;
+  int baud_rate_{};
+  bool low_latency_{false};
   std::shared_ptr<serial::Serial> serial_ptr_;
   std::shared_ptr<Ptp> ptp_;
+  std::shared_ptr<RawRecorder> recorder_{nullptr};
   std::thread rx_thread_, tx_thread_;
   bool started_{false};
+
+  std::atomic<uint64_t> stat_bytes_{0};
+  std::atomic<uint64_t> stat_reads_{0};
+  std::atomic<uint64_t> stat_max_chunk_{0};
+  std::atomic<uint64_t> stat_batch_byte_times_{0};
+  std::atomic<uint64_t> stat_handle_ns_{0};
 };
 }  // namespace infinite_sense
@@ -0,0 +1,63 @@
+#include "clock.h"
+#include "log.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+
+namespace infinite_sense {
+namespace {
+constexpr uint64_t k_wall_refresh_us = 100000;
+constexpr int64_t k_wall_step_log_us = 1000;
+std::atomic<int64_t> wall_offset_us{0};
+std::atomic<uint64_t> wall_offset_time_us{0};
+
+// 取若干次 (单调, 墙上, 单调) 采样中间隔最短的一次，降低线程被抢占带来的误差
+int64_t MeasureWallOffset() {
+  int64_t best_offset = 0;
+  uint64_t best_span = UINT64_MAX;
+  for (int i = 0; i < 3; ++i) {
+    const uint64_t before = HostClock::NowUs();
+    const uint64_t wall = HostClock::WallNowUs();
+    const uint64_t after = HostClock::NowUs();
+    if (after - before < best_span) {
+      best_span = after - before;
+      best_offset = static_cast<int64_t>(wall - (before + (after - before) / 2));
+    }
+  }
+  return best_offset;
+}
+}  // namespace
+
+uint64_t HostClock::NowUs() {
+  // libstdc++ 的 steady_clock 即 CLOCK_MONOTONIC
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+uint64_t HostClock::NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+uint64_t HostClock::WallNowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+int64_t HostClock::WallOffsetUs() {
+  const uint64_t now = NowUs();
+  const uint64_t last = wall_offset_time_us.load(std::memory_order_acquire);
+  if (last != 0 && now - last < k_wall_refresh_us) {
+    return wall_offset_us.load(std::memory_order_relaxed);
+  }
+  const int64_t offset = MeasureWallOffset();
+  const int64_t previous = wall_offset_us.exchange(offset, std::memory_order_relaxed);
+  wall_offset_time_us.store(now, std::memory_order_release);
+  if (last != 0 && std::llabs(offset - previous) > k_wall_step_log_us) {
+    LOG(INFO) << "Wall clock stepped by " << offset - previous << " us, monotonic time base unaffected";
+  }
+  return offset;
+}
+
+}  // namespace infinite_sense
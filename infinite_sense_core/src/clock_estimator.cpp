@@ -0,0 +1,128 @@
+#include "clock_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace infinite_sense {
+
+ClockEstimator::ClockEstimator(const size_t window) : window_(window < 2 ? 2 : window) {}
+
+void ClockEstimator::AddSample(const uint64_t host_us, const int64_t offset_us) {
+  std::lock_guard lock(lock_);
+  samples_.push_back({host_us, static_cast<double>(offset_us) + correction_us_});
+  while (samples_.size() > window_) {
+    samples_.pop_front();
+  }
+  Fit();
+}
+
+void ClockEstimator::ApplyCorrection(const int64_t offset_us) {
+  std::lock_guard lock(lock_);
+  correction_us_ += static_cast<double>(offset_us);
+  if (model_.valid) {
+    model_.offset_us -= static_cast<double>(offset_us);
+  }
+}
+
+ClockModel ClockEstimator::GetModel() const {
+  std::lock_guard lock(lock_);
+  return model_;
+}
+
+void ClockEstimator::Reset() {
+  std::lock_guard lock(lock_);
+  samples_.clear();
+  correction_us_ = 0;
+  model_ = ClockModel{};
+}
+
+void ClockEstimator::Fit() {
+  const size_t n = samples_.size();
+  if (n == 0) {
+    model_ = ClockModel{};
+    return;
+  }
+  // 以最新样本为参考时刻，主机时间换算为相对秒数，避免大整数带来的精度损失
+  const uint64_t ref = samples_.back().host_us;
+  double mean_x = 0, mean_y = 0;
+  for (const auto& s : samples_) {
+    mean_x += static_cast<double>(static_cast<int64_t>(s.host_us - ref)) * 1e-6;
+    mean_y += s.free_offset_us;
+  }
+  mean_x /= static_cast<double>(n);
+  mean_y /= static_cast<double>(n);
+  double sxx = 0, sxy = 0;
+  for (const auto& s : samples_) {
+    const double dx = static_cast<double>(static_cast<int64_t>(s.host_us - ref)) * 1e-6 - mean_x;
+    sxx += dx * dx;
+    sxy += dx * (s.free_offset_us - mean_y);
+  }
+  const double slope = (n >= 2 && sxx > 0) ? sxy / sxx : 0;  // us/s，即 ppm
+  const double intercept = mean_y - slope * mean_x;             // 参考时刻处的自由运行偏差
+
+  double sse = 0;
+  for (const auto& s : samples_) {
+    const double x = static_cast<double>(static_cast<int64_t>(s.host_us - ref)) * 1e-6;
+    const double r = s.free_offset_us - (intercept + slope * x);
+    sse += r * r;
+  }
+
+  model_.valid = true;
+  model_.ref_host_us = ref;
+  model_.offset_us = intercept - correction_us_;
+  model_.skew_ppm = slope;
+  model_.residual_us = std::sqrt(sse / static_cast<double>(n));
+  model_.samples = n;
+}
+
+MinRttFilter::MinRttFilter(const size_t window, const double mad_k, const int64_t margin_us)
+    : window_(window < 1 ? 1 : window), mad_k_(std::max(mad_k, 0.0)), margin_us_(margin_us) {
+  sorted_.reserve(window_);
+  deviations_.reserve(window_);
+}
+
+bool MinRttFilter::Accept(const int64_t delay_us) {
+  std::lock_guard lock(lock_);
+  delays_.push_back(delay_us);
+  while (delays_.size() > window_) {
+    delays_.pop_front();
+  }
+  sorted_.assign(delays_.begin(), delays_.end());
+  std::sort(sorted_.begin(), sorted_.end());
+  // 中位数绝对偏差对抢占离群样本不敏感，乘 1.4826 换算为正态分布下的标准差
+  const int64_t median = sorted_[sorted_.size() / 2];
+  deviations_.clear();
+  for (const int64_t delay : sorted_) {
+    deviations_.push_back(std::llabs(delay - median));
+  }
+  std::nth_element(deviations_.begin(), deviations_.begin() + deviations_.size() / 2, deviations_.end());
+  const double spread_us = 1.4826 * static_cast<double>(deviations_[deviations_.size() / 2]);
+  const auto margin_us = std::max(static_cast<int64_t>(std::llround(mad_k_ * spread_us)), margin_us_);
+  const int64_t threshold = sorted_.front() + margin_us;
+  const bool accepted = delay_us <= threshold;
+
+  ++stats_.exchanges;
+  if (accepted) {
+    ++stats_.accepted;
+  } else {
+    ++stats_.rejected;
+  }
+  stats_.min_delay_us = sorted_.front();
+  stats_.threshold_us = threshold;
+  stats_.last_delay_us = delay_us;
+  return accepted;
+}
+
+RttFilterStats MinRttFilter::GetStats() const {
+  std::lock_guard lock(lock_);
+  return stats_;
+}
+
+void MinRttFilter::Reset() {
+  std::lock_guard lock(lock_);
+  delays_.clear();
+  stats_ = RttFilterStats{};
+}
+
+}  // namespace infinite_sense
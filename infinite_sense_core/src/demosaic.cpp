@@ -0,0 +1,312 @@
+#include "demosaic.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define INFINITE_SENSE_X86_SIMD 1
+#endif
+
+namespace infinite_sense {
+namespace {
+
+// 一行的插值输入：三行均已转换为 8 位并左右各延拓 1 像素，下标 0 对应 x = -1
+struct RowParams {
+  const uint8_t *up;
+  const uint8_t *mid;
+  const uint8_t *down;
+  int width;
+  int site_parity;  // 本行 R 或 B 像素所在列的奇偶
+  bool red_row;     // 本行是否含 R 像素
+  bool edge_aware;
+  uint8_t *dst;
+};
+
+// 与 SIMD 的 avg 指令一致的取整方式，保证各实现输出逐字节相同
+inline uint8_t Avg(const uint8_t a, const uint8_t b) { return static_cast<uint8_t>((a + b + 1) >> 1); }
+
+void DemosaicRowScalar(const RowParams &p, const int begin) {
+  for (int x = begin; x < p.width; ++x) {
+    const uint8_t *u = p.up + x;
+    const uint8_t *m = p.mid + x;
+    const uint8_t *d = p.down + x;
+    const uint8_t h = Avg(m[0], m[2]);
+    const uint8_t v = Avg(u[1], d[1]);
+    // own 为本行的颜色（R 行为 R，B 行为 B），other 为另一种颜色
+    uint8_t own, green, other;
+    if ((x & 1) == p.site_parity) {
+      own = m[1];
+      green = Avg(h, v);
+      if (p.edge_aware) {
+        const int dh = std::abs(m[0] - m[2]);
+        const int dv = std::abs(u[1] - d[1]);
+        if (dh < dv) {
+          green = h;
+        } else if (dv < dh) {
+          green = v;
+        }
+      }
+      other = Avg(Avg(u[0], u[2]), Avg(d[0], d[2]));
+    } else {
+      own = h;
+      green = m[1];
+      other = v;
+    }
+    uint8_t *out = p.dst + 3 * x;
+    out[0] = p.red_row ? other : own;
+    out[1] = green;
+    out[2] = p.red_row ? own : other;
+  }
+}
+
+#ifdef INFINITE_SENSE_X86_SIMD
+// 16 个像素的 B、G、R 三个向量交织为 48 字节 BGR 的 pshufb 掩码，[输出块][通道]
+struct InterleaveMasks {
+  uint8_t mask[3][3][16];
+};
+
+constexpr InterleaveMasks MakeInterleaveMasks() {
+  InterleaveMasks masks{};
+  for (int chunk = 0; chunk < 3; ++chunk) {
+    for (int channel = 0; channel < 3; ++channel) {
+      for (int i = 0; i < 16; ++i) {
+        const int k = chunk * 16 + i;
+        masks.mask[chunk][channel][i] = k % 3 == channel ? static_cast<uint8_t>(k / 3) : 0x80;
+      }
+    }
+  }
+  return masks;
+}
+
+alignas(16) constexpr InterleaveMasks k_interleave = MakeInterleaveMasks();
+
+__attribute__((target("sse4.1"))) inline void StoreBgr(const __m128i b, const __m128i g, const __m128i r,
+                                                        uint8_t *out) {
+  for (int chunk = 0; chunk < 3; ++chunk) {
+    const auto *masks = k_interleave.mask[chunk];
+    const __m128i mask_b = _mm_load_si128(reinterpret_cast<const __m128i *>(masks[0]));
+    const __m128i mask_g = _mm_load_si128(reinterpret_cast<const __m128i *>(masks[1]));
+    const __m128i mask_r = _mm_load_si128(reinterpret_cast<const __m128i *>(masks[2]));
+    const __m128i bgr = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(b, mask_b), _mm_shuffle_epi8(g, mask_g)),
+                                     _mm_shuffle_epi8(r, mask_r));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * chunk), bgr);
+  }
+}
+
+__attribute__((target("sse4.1"))) inline __m128i Load16(const uint8_t *p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+
+__attribute__((target("sse4.1"))) int DemosaicRowSse4(const RowParams &p, const int begin) {
+  // 从偶数列开始，每个向量中 R/B 像素位于固定的字节位置
+  const __m128i site = _mm_set1_epi16(p.site_parity == 0 ? 0x00FF : static_cast<int16_t>(0xFF00));
+  int x = begin;
+  for (; x + 16 <= p.width; x += 16) {
+    const __m128i w = Load16(p.mid + x), c = Load16(p.mid + x + 1), e = Load16(p.mid + x + 2);
+    const __m128i n = Load16(p.up + x + 1), s = Load16(p.down + x + 1);
+    const __m128i h = _mm_avg_epu8(w, e);
+    const __m128i v = _mm_avg_epu8(n, s);
+    __m128i g = _mm_avg_epu8(h, v);
+    if (p.edge_aware) {
+      const __m128i dh = _mm_or_si128(_mm_subs_epu8(w, e), _mm_subs_epu8(e, w));
+      const __m128i dv = _mm_or_si128(_mm_subs_epu8(n, s), _mm_subs_epu8(s, n));
+      const __m128i low = _mm_min_epu8(dh, dv);
+      const __m128i tie = _mm_cmpeq_epi8(dh, dv);
+      g = _mm_blendv_epi8(g, h, _mm_andnot_si128(tie, _mm_cmpeq_epi8(low, dh)));
+      g = _mm_blendv_epi8(g, v, _mm_andnot_si128(tie, _mm_cmpeq_epi8(low, dv)));
+    }
+    const __m128i diag = _mm_avg_epu8(_mm_avg_epu8(Load16(p.up + x), Load16(p.up + x + 2)),
+                                      _mm_avg_epu8(Load16(p.down + x), Load16(p.down + x + 2)));
+    const __m128i own = _mm_blendv_epi8(h, c, site);
+    const __m128i green = _mm_blendv_epi8(c, g, site);
+    const __m128i other = _mm_blendv_epi8(v, diag, site);
+    if (p.red_row) {
+      StoreBgr(other, green, own, p.dst + 3 * x);
+    } else {
+      StoreBgr(own, green, other, p.dst + 3 * x);
+    }
+  }
+  return x;
+}
+
+__attribute__((target("avx2"))) inline __m256i Load32(const uint8_t *p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+__attribute__((target("avx2"))) int DemosaicRowAvx2(const RowParams &p) {
+  const __m256i site = _mm256_set1_epi16(p.site_parity == 0 ? 0x00FF : static_cast<int16_t>(0xFF00));
+  int x = 0;
+  for (; x + 32 <= p.width; x += 32) {
+    const __m256i w = Load32(p.mid + x), c = Load32(p.mid + x + 1), e = Load32(p.mid + x + 2);
+    const __m256i n = Load32(p.up + x + 1), s = Load32(p.down + x + 1);
+    const __m256i h = _mm256_avg_epu8(w, e);
+    const __m256i v = _mm256_avg_epu8(n, s);
+    __m256i g = _mm256_avg_epu8(h, v);
+    if (p.edge_aware) {
+      const __m256i dh = _mm256_or_si256(_mm256_subs_epu8(w, e), _mm256_subs_epu8(e, w));
+      const __m256i dv = _mm256_or_si256(_mm256_subs_epu8(n, s), _mm256_subs_epu8(s, n));
+      const __m256i low = _mm256_min_epu8(dh, dv);
+      const __m256i tie = _mm256_cmpeq_epi8(dh, dv);
+      g = _mm256_blendv_epi8(g, h, _mm256_andnot_si256(tie, _mm256_cmpeq_epi8(low, dh)));
+      g = _mm256_blendv_epi8(g, v, _mm256_andnot_si256(tie, _mm256_cmpeq_epi8(low, dv)));
+    }
+    const __m256i diag = _mm256_avg_epu8(_mm256_avg_epu8(Load32(p.up + x), Load32(p.up + x + 2)),
+                                         _mm256_avg_epu8(Load32(p.down + x), Load32(p.down + x + 2)));
+    const __m256i own = _mm256_blendv_epi8(h, c, site);
+    const __m256i green = _mm256_blendv_epi8(c, g, site);
+    const __m256i other = _mm256_blendv_epi8(v, diag, site);
+    const __m256i b = p.red_row ? other : own;
+    const __m256i r = p.red_row ? own : other;
+    // 跨 128 位通道的交织代价较高，按两个 16 像素的半段分别交织
+    StoreBgr(_mm256_castsi256_si128(b), _mm256_castsi256_si128(green), _mm256_castsi256_si128(r), p.dst + 3 * x);
+    StoreBgr(_mm256_extracti128_si256(b, 1), _mm256_extracti128_si256(green, 1), _mm256_extracti128_si256(r, 1),
+             p.dst + 3 * (x + 16));
+  }
+  return x;
+}
+#endif
+
+// 把一行原始数据转换为 8 位，并按镜像延拓左右各 1 像素
+void LoadRow(const BayerImage &src, const int y, uint8_t *row) {
+  uint8_t *out = row + 1;
+  const uint8_t *in = src.data + static_cast<size_t>(y) * src.stride;
+  if (src.bit_depth == 8) {
+    std::memcpy(out, in, static_cast<size_t>(src.width));
+  } else if (src.packed) {
+    // 每 2 像素 3 字节，第 0、2 字节为两个像素的高 8 位
+    for (int x = 0; x < src.width; x += 2) {
+      out[x] = in[3 * (x / 2)];
+      out[x + 1] = in[3 * (x / 2) + 2];
+    }
+  } else {
+    const int shift = src.bit_depth - 8;
+    for (int x = 0; x < src.width; ++x) {
+      uint16_t value;
+      std::memcpy(&value, in + 2 * x, sizeof(value));
+      out[x] = static_cast<uint8_t>(std::min(value >> shift, 255));
+    }
+  }
+  row[0] = out[1];
+  row[src.width + 1] = out[src.width - 2];
+}
+
+size_t RowBytes(const BayerImage &src) {
+  const auto width = static_cast<size_t>(src.width);
+  if (src.bit_depth == 8) {
+    return width;
+  }
+  return src.packed ? width / 2 * 3 : width * 2;
+}
+
+// 逐行去马赛克，dst_row(y) 给出第 y 行的 BGR 输出位置，row_done(y) 在该行写完后调用
+template <typename DstRow, typename RowDone>
+bool DemosaicRows(const BayerImage &src, const DemosaicMethod method, SimdLevel level, DstRow dst_row,
+                  RowDone row_done) {
+  if (src.data == nullptr || src.width < 2 || src.height < 2) {
+    return false;
+  }
+  if (src.bit_depth != 8 && src.bit_depth != 10 && src.bit_depth != 12) {
+    return false;
+  }
+  if (src.packed && (src.bit_depth == 8 || src.width % 2 != 0)) {
+    return false;
+  }
+  if (src.stride < RowBytes(src)) {
+    return false;
+  }
+  level = std::min(level, BestSimdLevel());
+
+  // R 像素所在的行、列奇偶
+  const int red_row = src.pattern == BayerPattern::RGGB || src.pattern == BayerPattern::GRBG ? 0 : 1;
+  const int red_col = src.pattern == BayerPattern::RGGB || src.pattern == BayerPattern::GBRG ? 0 : 1;
+
+  // 三行滚动缓冲，源行 r 存放在第 r % 3 行
+  const size_t row_size = static_cast<size_t>(src.width) + 2;
+  std::vector<uint8_t> rows(3 * row_size);
+  int loaded[3] = {-1, -1, -1};
+  const auto row = [&](int r) -> const uint8_t * {
+    r = r < 0 ? 1 : (r >= src.height ? src.height - 2 : r);
+    uint8_t *slot = rows.data() + static_cast<size_t>(r % 3) * row_size;
+    if (loaded[r % 3] != r) {
+      LoadRow(src, r, slot);
+      loaded[r % 3] = r;
+    }
+    return slot;
+  };
+
+  for (int y = 0; y < src.height; ++y) {
+    RowParams p{};
+    p.up = row(y - 1);
+    p.mid = row(y);
+    p.down = row(y + 1);
+    p.width = src.width;
+    p.red_row = (y & 1) == red_row;
+    p.site_parity = p.red_row ? red_col : 1 - red_col;
+    p.edge_aware = method == DemosaicMethod::EDGE_AWARE;
+    p.dst = dst_row(y);
+    int x = 0;
+#ifdef INFINITE_SENSE_X86_SIMD
+    if (level == SimdLevel::AVX2) {
+      x = DemosaicRowAvx2(p);
+    }
+    if (level >= SimdLevel::SSE4) {
+      x = DemosaicRowSse4(p, x);
+    }
+#endif
+    DemosaicRowScalar(p, x);
+    row_done(y);
+  }
+  return true;
+}
+}  // namespace
+
+SimdLevel BestSimdLevel() {
+#ifdef INFINITE_SENSE_X86_SIMD
+  static const SimdLevel level = [] {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+      return SimdLevel::SSE4;
+    }
+    return SimdLevel::SCALAR;
+  }();
+  return level;
+#else
+  return SimdLevel::SCALAR;
+#endif
+}
+
+bool DemosaicBayer(const BayerImage &src, uint8_t *bgr, const size_t bgr_stride, const DemosaicMethod method,
+                   const SimdLevel level) {
+  if (bgr == nullptr || bgr_stride < static_cast<size_t>(src.width) * 3) {
+    return false;
+  }
+  return DemosaicRows(
+      src, method, level, [&](const int y) { return bgr + static_cast<size_t>(y) * bgr_stride; }, [](int) {});
+}
+
+bool BayerToGray(const BayerImage &src, uint8_t *gray, const size_t gray_stride, const SimdLevel level) {
+  if (gray == nullptr || gray_stride < static_cast<size_t>(src.width)) {
+    return false;
+  }
+  // 每行先插值到一行 BGR 临时缓冲，整帧不落地 BGR
+  std::vector<uint8_t> bgr(static_cast<size_t>(src.width) * 3);
+  return DemosaicRows(
+      src, DemosaicMethod::BILINEAR, level, [&](int) { return bgr.data(); },
+      [&](const int y) { BgrToGrayRow(bgr.data(), gray + static_cast<size_t>(y) * gray_stride, src.width); });
+}
+
+void BgrToGrayRow(const uint8_t *bgr, uint8_t *gray, const int width) {
+  // BT.601 亮度，权重之和为 256
+  for (int x = 0; x < width; ++x) {
+    const uint8_t *p = bgr + 3 * x;
+    gray[x] = static_cast<uint8_t>((29 * p[0] + 150 * p[1] + 77 * p[2] + 128) >> 8);
+  }
+}
+
+}  // namespace infinite_sense
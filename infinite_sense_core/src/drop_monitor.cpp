@@ -0,0 +1,147 @@
+#include "drop_monitor.h"
+#include "clock.h"
+#include "log.h"
+#include "messenger.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace infinite_sense {
+
+FrameDropMonitor::FrameDropMonitor(const TriggerDevice dev, std::string name, const uint32_t backlog_threshold,
+                                   const uint64_t publish_period_us)
+    : dev_(dev),
+      name_(std::move(name)),
+      topic_(name_ + "_drops"),
+      backlog_threshold_(backlog_threshold),
+      publish_period_us_(publish_period_us),
+      lost_(TriggerManger::GetInstance().GetLostTriggers(dev)),
+      pending_lost_(lost_) {}
+
+void FrameDropMonitor::Update(const uint64_t frame_num, const TriggerEvent* trigger, const TriggerWindow& window) {
+  ++stats_.frames;
+  bool restarted = false;
+  if (has_frame_) {
+    if (frame_num > last_frame_num_ + 1) {
+      stats_.lost_frames += frame_num - last_frame_num_ - 1;
+    } else if (frame_num <= last_frame_num_) {
+      // 相机重新开始取流，帧计数从头开始
+      restarted = true;
+    }
+  }
+  has_frame_ = true;
+  last_frame_num_ = frame_num;
+
+  TriggerManger& manager = TriggerManger::GetInstance();
+  if (TriggerEvent latest; manager.GetLatestTrigger(dev_, latest)) {
+    const uint64_t count = latest.index + 1 + manager.GetLostTriggers(dev_);
+    if (!has_count_ || restarted) {
+      first_count_ = count;
+      has_count_ = true;
+    }
+  }
+  if (restarted) {
+    has_base_ = false;
+  }
+  CountMissed(frame_num, window);
+
+  if (trigger == nullptr) {
+    ++stats_.untriggered;
+  } else if (TriggerEvent latest; manager.GetLatestTrigger(dev_, latest)) {
+    stats_.backlog = latest.index > trigger->index ? static_cast<uint32_t>(latest.index - trigger->index) : 0;
+    stats_.max_backlog = std::max(stats_.max_backlog, stats_.backlog);
+    if (stats_.backlog > backlog_threshold_) {
+      ++stats_.slow_frames;
+    }
+  }
+  Poll();
+}
+
+uint64_t FrameDropMonitor::CountBefore(const uint64_t time_us, bool& found) const {
+  TriggerEvent event;
+  if (!TriggerManger::GetInstance().GetTriggerBefore(dev_, time_us, event)) {
+    found = false;
+    return 0;
+  }
+  return event.index + 1 + lost_;
+}
+
+void FrameDropMonitor::CountMissed(const uint64_t frame_num, const TriggerWindow& window) {
+  TriggerManger& manager = TriggerManger::GetInstance();
+  // 丢失的触发消息在其后的触发到达时才计入，只有 earliest_us 越过该触发后，丢失的触发才确定早于窗口
+  if (const uint64_t lost = manager.GetLostTriggers(dev_); lost != pending_lost_) {
+    pending_lost_ = lost;
+    if (TriggerEvent latest; manager.GetLatestTrigger(dev_, latest)) {
+      pending_lost_us_ = latest.time_us;
+    }
+  }
+  if (pending_lost_ != lost_ && window.earliest_us > pending_lost_us_) {
+    lost_ = pending_lost_;
+  }
+  if (window.earliest_us == 0) {
+    return;
+  }
+  // 该帧的触发位于 [earliest_us, latest_us] 内：早于窗口的触发数给出下限，不晚于窗口的触发数给出上限
+  bool found = true;
+  const uint64_t below = CountBefore(window.earliest_us - 1, found);
+  const uint64_t upto = CountBefore(window.latest_us, found);
+  if (!found) {
+    return;
+  }
+  if (!has_base_) {
+    // 以窗口内只有一个触发的帧为基准，此时该帧之前的触发数是确定的
+    if (upto != below + 1) {
+      return;
+    }
+    base_count_ = below;
+    base_frame_num_ = frame_num;
+    committed_ = 0;
+    has_pending_ = false;
+    has_period_ = false;
+    has_base_ = true;
+  }
+  const auto frames = static_cast<int64_t>(frame_num - base_frame_num_);
+  const int64_t lower = static_cast<int64_t>(below - base_count_) - frames;
+  const int64_t upper = static_cast<int64_t>(upto - 1 - base_count_) - frames;
+  // 漏触发数只增不减，之后任一帧的上限都不小于之前的真实值
+  if (has_pending_) {
+    pending_ = std::min(pending_, upper);
+  }
+  period_lower_ = has_period_ ? std::max(period_lower_, lower) : lower;
+  has_period_ = true;
+}
+
+void FrameDropMonitor::Poll() {
+  const uint64_t now = HostClock::NowUs();
+  if (last_publish_us_ != 0 && now - last_publish_us_ < publish_period_us_) {
+    return;
+  }
+  last_publish_us_ = now;
+  stats_.time_stamp_us = now;
+  TriggerManger& manager = TriggerManger::GetInstance();
+  if (TriggerEvent latest; has_count_ && manager.GetLatestTrigger(dev_, latest)) {
+    const uint64_t count = latest.index + 1 + manager.GetLostTriggers(dev_);
+    stats_.triggers = count >= first_count_ ? count - first_count_ + 1 : 0;
+  }
+  // 上一周期的候选值经本周期所有帧的上限检验后才计入，积压帧集中送达造成的下限偏高不会被误计
+  if (has_period_) {
+    if (has_pending_ && pending_ > committed_) {
+      stats_.missed_triggers += static_cast<uint64_t>(pending_ - committed_);
+      committed_ = pending_;
+    }
+    pending_ = period_lower_;
+    has_pending_ = true;
+    has_period_ = false;
+  }
+  if (stats_.missed_triggers != published_.missed_triggers || stats_.lost_frames != published_.lost_frames ||
+      stats_.slow_frames != published_.slow_frames) {
+    LOG(WARNING) << name_ << " losing frames: missed triggers +" << stats_.missed_triggers - published_.missed_triggers
+                 << ", lost frames +" << stats_.lost_frames - published_.lost_frames << ", slow frames +"
+                 << stats_.slow_frames - published_.slow_frames << " (backlog max " << stats_.max_backlog << ")";
+  }
+  Messenger::GetInstance().PubStruct(topic_, &stats_, sizeof(stats_));
+  published_ = stats_;
+  stats_.max_backlog = stats_.backlog;
+}
+
+}  // namespace infinite_sense
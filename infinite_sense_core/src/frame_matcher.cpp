@@ -0,0 +1,94 @@
+#include "frame_matcher.h"
+#include "log.h"
+
+#include <utility>
+#include <vector>
+
+namespace infinite_sense {
+
+// 连续多少帧得到相同差值后锁定
+constexpr int k_lock_frames = 5;
+// 连续多少帧迟到后判定为漏触发
+constexpr int k_late_frames = 3;
+
+FrameTriggerMatcher::FrameTriggerMatcher(const TriggerDevice dev, std::string name)
+    : dev_(dev), name_(std::move(name)), lost_triggers_(TriggerManger::GetInstance().GetLostTriggers(dev)) {}
+
+bool FrameTriggerMatcher::Match(const uint64_t frame_num, const TriggerWindow& window, TriggerEvent& trigger) {
+  ++stats_.frames;
+  const TriggerManger& manager = TriggerManger::GetInstance();
+
+  if (const uint64_t lost = manager.GetLostTriggers(dev_); lost != lost_triggers_) {
+    lost_triggers_ = lost;
+    if (stats_.locked) {
+      Unlock("trigger messages lost");
+    }
+  }
+
+  if (stats_.locked) {
+    const auto index = static_cast<uint64_t>(static_cast<int64_t>(frame_num) + stats_.offset);
+    if (!manager.GetTriggerByIndex(dev_, index, trigger) || trigger.time_us > window.locked_latest_us) {
+      Unlock("frame counter does not match trigger index");
+    } else if (!CheckLate(window, trigger)) {
+      Unlock("frames keep arriving later than the latency bound, trigger missed");
+    } else {
+      ++stats_.by_counter;
+      return true;
+    }
+  }
+
+  const std::vector<TriggerEvent> candidates = manager.GetTriggersInRange(dev_, window.earliest_us, window.latest_us);
+  if (candidates.size() != 1) {
+    // 无法确定所属触发，取窗口上限前最近的触发，不参与对齐
+    ++stats_.ambiguous;
+    candidate_frames_ = 0;
+    if (!manager.GetTriggerBefore(dev_, window.latest_us, trigger)) {
+      ++stats_.unmatched;
+      return false;
+    }
+    ++stats_.by_time;
+    return true;
+  }
+  trigger = candidates.front();
+  ++stats_.by_time;
+  const int64_t offset = static_cast<int64_t>(trigger.index) - static_cast<int64_t>(frame_num);
+  if (candidate_frames_ > 0 && offset == candidate_offset_) {
+    ++candidate_frames_;
+  } else {
+    candidate_offset_ = offset;
+    candidate_frames_ = 1;
+  }
+  if (candidate_frames_ >= k_lock_frames) {
+    stats_.locked = true;
+    stats_.offset = offset;
+    ++stats_.locks;
+    late_frames_ = 0;
+    has_last_ = false;
+    LOG(INFO) << name_ << " frame counter locked to trigger index, offset " << offset;
+  }
+  return true;
+}
+
+bool FrameTriggerMatcher::CheckLate(const TriggerWindow& window, const TriggerEvent& trigger) {
+  const uint64_t latency = window.arrival_us > trigger.time_us ? window.arrival_us - trigger.time_us : 0;
+  if (trigger.time_us >= window.locked_earliest_us) {
+    late_frames_ = 0;
+  } else if (!has_last_ || trigger.time_us <= last_trigger_us_ ||
+             latency + (trigger.time_us - last_trigger_us_) / 2 >= last_latency_us_) {
+    // 积压帧被集中取出时延迟比上一帧少约一个触发间隔，不计为迟到
+    ++late_frames_;
+  }
+  has_last_ = true;
+  last_trigger_us_ = trigger.time_us;
+  last_latency_us_ = latency;
+  return late_frames_ < k_late_frames;
+}
+
+void FrameTriggerMatcher::Unlock(const char* reason) {
+  ++stats_.mismatches;
+  stats_.locked = false;
+  candidate_frames_ = 0;
+  LOG(WARNING) << name_ << " " << reason << " (mismatch " << stats_.mismatches << "), re-aligning by arrival time";
+}
+
+}  // namespace infinite_sense
@@ -0,0 +1,128 @@
+#include "frameset.h"
+#include "clock.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace infinite_sense {
+
+FrameSetAggregator::FrameSetAggregator(FrameSetConfig config) : config_(std::move(config)) {
+  stats_.missing.assign(config_.cameras.size(), 0);
+}
+
+void FrameSetAggregator::Subscribe(FrameSetCallback callback) {
+  std::lock_guard lock(lock_);
+  callbacks_.push_back(std::move(callback));
+}
+
+void FrameSetAggregator::Add(const std::string& name, const TriggerEvent& trigger,
+                             std::shared_ptr<const RawFrame> frame) {
+  const uint64_t now_ns = HostClock::NowNs();
+  std::vector<std::shared_ptr<const FrameSet>> ready;
+  {
+    std::lock_guard lock(lock_);
+    ++stats_.frames;
+    const auto camera = std::find(config_.cameras.begin(), config_.cameras.end(), name);
+    if (camera == config_.cameras.end()) {
+      ++stats_.unknown;
+      return;
+    }
+    const auto slot = static_cast<size_t>(camera - config_.cameras.begin());
+
+    auto it = pending_.find(trigger.time_us);
+    if (it == pending_.end()) {
+      if (trigger.time_us <= last_finished_us_) {
+        ++stats_.late;
+        return;
+      }
+      Pending pending;
+      pending.set = std::make_shared<FrameSet>();
+      pending.set->time_stamp_us = trigger.time_us;
+      pending.set->trigger_seq = trigger.seq;
+      pending.set->frames.resize(config_.cameras.size());
+      pending.first_ns = now_ns;
+      it = pending_.emplace(trigger.time_us, std::move(pending)).first;
+    }
+
+    Pending& pending = it->second;
+    if (pending.set->frames[slot]) {
+      ++stats_.duplicates;
+    } else {
+      ++pending.count;
+    }
+    pending.set->frames[slot] = std::move(frame);
+    if (pending.count == config_.cameras.size()) {
+      Finish(it, ready);
+    }
+    Expire(now_ns, ready);
+  }
+  Publish(ready);
+}
+
+void FrameSetAggregator::Flush() {
+  std::vector<std::shared_ptr<const FrameSet>> ready;
+  {
+    std::lock_guard lock(lock_);
+    while (!pending_.empty()) {
+      Finish(pending_.begin(), ready);
+    }
+  }
+  Publish(ready);
+}
+
+FrameSetStats FrameSetAggregator::GetStats() const {
+  std::lock_guard lock(lock_);
+  return stats_;
+}
+
+void FrameSetAggregator::Finish(const std::map<uint64_t, Pending>::iterator it,
+                                std::vector<std::shared_ptr<const FrameSet>>& ready) {
+  const Pending& pending = it->second;
+  last_finished_us_ = std::max(last_finished_us_, it->first);
+  if (pending.count == config_.cameras.size()) {
+    pending.set->complete = true;
+    ++stats_.complete;
+    ready.push_back(pending.set);
+  } else {
+    for (size_t i = 0; i < pending.set->frames.size(); ++i) {
+      if (!pending.set->frames[i]) {
+        ++stats_.missing[i];
+      }
+    }
+    if (config_.policy == FrameSetPolicy::PUBLISH_PARTIAL && pending.count >= config_.min_frames) {
+      ++stats_.partial;
+      ready.push_back(pending.set);
+    } else {
+      ++stats_.dropped;
+    }
+  }
+  pending_.erase(it);
+}
+
+void FrameSetAggregator::Expire(const uint64_t now_ns, std::vector<std::shared_ptr<const FrameSet>>& ready) {
+  const uint64_t timeout_ns = config_.timeout_us * 1000;
+  for (auto it = pending_.begin(); it != pending_.end();) {
+    const auto next = std::next(it);
+    if (now_ns - it->second.first_ns > timeout_ns) {
+      Finish(it, ready);
+    }
+    it = next;
+  }
+  while (pending_.size() > config_.max_pending) {
+    Finish(pending_.begin(), ready);
+  }
+}
+
+void FrameSetAggregator::Publish(const std::vector<std::shared_ptr<const FrameSet>>& ready) const {
+  if (ready.empty()) {
+    return;
+  }
+  // 回调只在相机启动前注册，此处无需加锁
+  for (const auto& set : ready) {
+    for (const auto& callback : callbacks_) {
+      callback(set);
+    }
+  }
+}
+
+}  // namespace infinite_sense
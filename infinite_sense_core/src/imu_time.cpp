@@ -0,0 +1,109 @@
+#include "imu_time.h"
+#include "config.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace infinite_sense {
+
+constexpr uint64_t k_counter_wrap = 1ULL << 32;
+constexpr uint64_t k_counter_wrap_window = 1ULL << 16;
+constexpr double k_step_min_us = 200;
+constexpr double k_step_ratio = 0.25;
+constexpr double k_period_gain = 0.01;
+constexpr double k_smoothing_gain = 0.05;
+
+uint64_t ImuTimeConditioner::Process(const uint64_t raw_us, const uint64_t counter, uint8_t& flags) {
+  std::lock_guard lock(lock_);
+  flags = 0;
+  ++stats_.samples;
+  if (!has_last_) {
+    has_last_ = true;
+    last_raw_us_ = raw_us;
+    last_counter_ = counter;
+    last_out_us_ = static_cast<double>(raw_us);
+    period_us_ = nominal_period_us_;
+    return raw_us;
+  }
+
+  uint64_t frames = counter - last_counter_;
+  if (counter <= last_counter_) {
+    if (last_counter_ >= k_counter_wrap - k_counter_wrap_window && counter < k_counter_wrap_window) {
+      frames = counter + k_counter_wrap - last_counter_;
+      flags |= IMU_TIME_WRAP;
+      ++stats_.wraps;
+    } else {
+      flags |= IMU_TIME_RESET;
+      ++stats_.resets;
+      LOG(WARNING) << "IMU counter went back from " << last_counter_ << " to " << counter << ", device reset?";
+      last_raw_us_ = raw_us;
+      last_counter_ = counter;
+      last_out_us_ = static_cast<double>(raw_us);
+      return raw_us;
+    }
+  }
+  if (frames > 1) {
+    flags |= IMU_TIME_GAP;
+    ++stats_.gaps;
+    stats_.dropped += frames - 1;
+  }
+
+  const auto dt = static_cast<double>(static_cast<int64_t>(raw_us - last_raw_us_));
+  const double expected = period_us_ * static_cast<double>(frames);
+  if (dt <= 0) {
+    flags |= IMU_TIME_BACKWARD;
+    ++stats_.steps;
+  } else if (period_us_ > 0 && std::abs(dt - expected) > std::max(k_step_min_us, k_step_ratio * period_us_)) {
+    flags |= IMU_TIME_STEP;
+    ++stats_.steps;
+  }
+  const bool continuous = (flags & (IMU_TIME_STEP | IMU_TIME_BACKWARD)) == 0;
+  const bool period_known = period_us_ > 0;
+
+  // 只用连续的样本更新采样周期；指定了标称频率时周期固定
+  if (continuous && nominal_period_us_ <= 0) {
+    const double interval = dt / static_cast<double>(frames);
+    period_us_ = period_us_ > 0 ? period_us_ + k_period_gain * (interval - period_us_) : interval;
+  }
+
+  double out = static_cast<double>(raw_us);
+  if (smoothing_ && continuous && period_known) {
+    const double predicted = last_out_us_ + expected;
+    out = predicted + k_smoothing_gain * (static_cast<double>(raw_us) - predicted);
+    flags |= IMU_TIME_SMOOTHED;
+  }
+  last_raw_us_ = raw_us;
+  last_counter_ = counter;
+  last_out_us_ = out;
+  return static_cast<uint64_t>(std::llround(out));
+}
+
+void ImuTimeConditioner::SetSmoothing(const bool enable) {
+  std::lock_guard lock(lock_);
+  smoothing_ = enable;
+}
+
+void ImuTimeConditioner::SetNominalRate(const double rate_hz) {
+  std::lock_guard lock(lock_);
+  nominal_period_us_ = rate_hz > 0 ? 1e6 / rate_hz : 0;
+  if (nominal_period_us_ > 0) {
+    period_us_ = nominal_period_us_;
+  }
+}
+
+ImuTimeStats ImuTimeConditioner::GetStats() const {
+  std::lock_guard lock(lock_);
+  ImuTimeStats stats = stats_;
+  stats.period_us = period_us_;
+  return stats;
+}
+
+void ImuTimeConditioner::Reset() {
+  std::lock_guard lock(lock_);
+  has_last_ = false;
+  period_us_ = nominal_period_us_;
+  stats_ = ImuTimeStats{};
+}
+
+}  // namespace infinite_sense
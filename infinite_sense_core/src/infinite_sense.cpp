@@ -3,6 +3,9 @@
 #include "trigger.h"
 #include "net.h"
 #include "usb.h"
+#include "replay.h"
+#include "recorder.h"
+#include "ptp.h"
 #include "messenger.h"
 #include "log.h"
 
@@ -17,22 +20,74 @@ void Synchronizer::SetNetLink(std::string net_dev, const unsigned int port) {
   net_ip_ = std::move(net_dev);
   net_port_ = port;
   net_manager_ = std::make_shared<NetManager>(net_ip_, net_port_);
+  replay_manager_ = nullptr;
 }
-void Synchronizer::SetUsbLink(std::string serial_dev, const int serial_baud_rate) {
+void Synchronizer::SetUsbLink(std::string serial_dev, const int serial_baud_rate, const bool low_latency) {
   serial_dev_ = std::move(serial_dev);
   serial_baud_rate_ = serial_baud_rate;
-  serial_manager_ = std::make_shared<UsbManager>(serial_dev_, serial_baud_rate_);
+  serial_manager_ = std::make_shared<UsbManager>(serial_dev_, serial_baud_rate_, low_latency);
   net_manager_ = nullptr;
+  replay_manager_ = nullptr;
 }
+void Synchronizer::SetReplayLink(std::string path, const double speed) {
+  replay_manager_ = std::make_shared<ReplayManager>(std::move(path), speed);
+  net_manager_ = nullptr;
+  serial_manager_ = nullptr;
+}
+void Synchronizer::SetRecordPath(const std::string& path) { recorder_ = std::make_shared<RawRecorder>(path); }
+void Synchronizer::SetPtpLogPath(const std::string& path) { ptp_log_ = std::make_shared<PtpExchangeLog>(path); }
 void Synchronizer::UseSensor(const std::shared_ptr<Sensor>& sensor) { sensor_manager_ = sensor; }
+void Synchronizer::SetImuTimeSmoothing(const bool smoothing, const double nominal_rate_hz) {
+  ImuTimeConditioner::GetInstance().SetSmoothing(smoothing);
+  ImuTimeConditioner::GetInstance().SetNominalRate(nominal_rate_hz);
+}
+ImuTimeStats Synchronizer::GetImuTimeStats() const { return ImuTimeConditioner::GetInstance().GetStats(); }
+bool Synchronizer::GetUsbLatencyStats(SerialLatencyStats& stats) const {
+  if (!serial_manager_) {
+    return false;
+  }
+  stats = serial_manager_->GetLatencyStats();
+  return true;
+}
+
+std::shared_ptr<Ptp> Synchronizer::ActivePtp() const {
+  if (net_manager_) {
+    return net_manager_->GetPtp();
+  }
+  if (serial_manager_) {
+    return serial_manager_->GetPtp();
+  }
+  return nullptr;
+}
+ClockModel Synchronizer::GetClockModel() const {
+  const auto ptp = ActivePtp();
+  return ptp ? ptp->GetClockModel() : ClockModel{};
+}
+RttFilterStats Synchronizer::GetPtpFilterStats() const {
+  const auto ptp = ActivePtp();
+  return ptp ? ptp->GetFilterStats() : RttFilterStats{};
+}
+SyncQuality Synchronizer::GetSyncQuality() const {
+  const auto ptp = ActivePtp();
+  return ptp ? ptp->GetSyncQuality() : SyncQuality{};
+}
 
 void Synchronizer::Start() const {
+  ImuTimeConditioner::GetInstance().Reset();
+  if (const auto ptp = ActivePtp(); ptp && ptp_log_) {
+    ptp->SetExchangeLog(ptp_log_);
+  }
   if (net_manager_) {
+    net_manager_->SetRecorder(recorder_);
     net_manager_->Start();
   }
   if (serial_manager_) {
+    serial_manager_->SetRecorder(recorder_);
     serial_manager_->Start();
   }
+  if (replay_manager_) {
+    replay_manager_->Start();
+  }
   if (sensor_manager_) {
     std::this_thread::sleep_for(std::chrono::milliseconds{2000});
     sensor_manager_->Initialization();
@@ -47,6 +102,15 @@ void Synchronizer::Stop() const {
   if (serial_manager_) {
     serial_manager_->Stop();
   }
+  if (replay_manager_) {
+    replay_manager_->Stop();
+  }
+  if (recorder_) {
+    recorder_->Flush();
+  }
+  if (ptp_log_) {
+    ptp_log_->Flush();
+  }
   if (sensor_manager_) {
     sensor_manager_->Stop();
   }
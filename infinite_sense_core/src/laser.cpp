@@ -0,0 +1,143 @@
+#include "laser.h"
+#include "clock.h"
+#include "messenger.h"
+#include "time_translator.h"
+#include "trigger.h"
+
+#include <cstdio>
+#include <ctime>
+#include <utility>
+
+namespace infinite_sense {
+
+constexpr size_t k_nmea_queue_max = 4;
+
+LaserManager::LaserManager() { channels_.push_back({LASER, "laser", "laser_nmea"}); }
+
+LaserManager::~LaserManager() {
+  {
+    std::lock_guard lock(queue_lock_);
+    stop_ = true;
+  }
+  queue_cv_.notify_all();
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+}
+
+void LaserManager::AddChannel(const TriggerDevice dev, const std::string& name) {
+  if (static_cast<size_t>(dev) >= k_trigger_channel_count) {
+    LOG(ERROR) << "Laser channel " << dev << " out of range, max " << k_trigger_channel_count;
+    return;
+  }
+  std::lock_guard lock(lock_);
+  for (auto& channel : channels_) {
+    if (channel.dev == dev) {
+      channel.name = name;
+      channel.nmea_topic = name + "_nmea";
+      return;
+    }
+  }
+  channels_.push_back({dev, name, name + "_nmea"});
+}
+
+void LaserManager::SetNmea(const bool enable, NmeaSink sink) {
+  std::lock_guard lock(lock_);
+  nmea_ = enable;
+  sink_ = std::move(sink);
+  if (nmea_ && sink_ && !writer_.joinable()) {
+    writer_ = std::thread(&LaserManager::Write, this);
+  }
+}
+
+void LaserManager::Write() {
+  while (true) {
+    std::string sentence;
+    {
+      std::unique_lock lock(queue_lock_);
+      queue_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (stop_) {
+        return;
+      }
+      sentence = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    NmeaSink sink;
+    {
+      std::lock_guard lock(lock_);
+      sink = sink_;
+    }
+    if (sink) {
+      sink(sentence);
+    }
+  }
+}
+
+void LaserManager::Process(const uint64_t time_us, const uint64_t mask, const uint64_t seq) {
+  std::lock_guard lock(lock_);
+  uint64_t utc_us = 0;
+  for (const auto& channel : channels_) {
+    if (((mask >> channel.dev) & 1) == 0) {
+      continue;
+    }
+    if (utc_us == 0) {
+      // 激光雷达把脉冲沿当作语句所写的整秒：相邻脉冲依次加一秒，避免换算抖动在半秒附近时重复或跳过一秒
+      const uint64_t host_utc_us = HostClock::ToWallUs(TimeTranslator::GetInstance().ToHostTime(time_us) / 1000);
+      uint64_t utc_s = (host_utc_us + 500000) / 1000000;
+      if (last_utc_s_ != 0 && time_us > last_time_us_) {
+        const uint64_t next_s = last_utc_s_ + (time_us - last_time_us_ + 500000) / 1000000;
+        if (next_s * 1000000 + 1000000 > host_utc_us && next_s * 1000000 < host_utc_us + 1000000) {
+          utc_s = next_s;
+        }
+      }
+      last_time_us_ = time_us;
+      last_utc_s_ = utc_s;
+      utc_us = utc_s * 1000000;
+    }
+    LaserData laser{};
+    laser.time_stamp_us = time_us;
+    laser.utc_us = utc_us;
+    laser.seq = seq;
+    laser.name = channel.name;
+    // 触发消息由同一线程先写入 TriggerManger，最近一次触发即本次脉冲
+    if (TriggerEvent event; TriggerManger::GetInstance().GetLatestTrigger(channel.dev, event)) {
+      laser.index = event.index;
+    }
+    Messenger::GetInstance().PubStruct(channel.name, &laser, sizeof(laser));
+    if (nmea_) {
+      const std::string sentence = FormatGprmc(utc_us);
+      Messenger::GetInstance().Pub(channel.nmea_topic, sentence);
+      if (sink_) {
+        std::lock_guard queue_lock(queue_lock_);
+        if (queue_.size() >= k_nmea_queue_max) {
+          // 输出跟不上时旧语句已错过对应的脉冲，丢弃
+          LOG(WARNING) << channel.name << " NMEA sink too slow, dropping the oldest sentence";
+          queue_.pop_front();
+        }
+        queue_.push_back(sentence);
+        queue_cv_.notify_one();
+      }
+    }
+  }
+}
+
+std::string LaserManager::FormatGprmc(const uint64_t utc_us) {
+  const auto seconds = static_cast<std::time_t>(utc_us / 1000000);
+  const auto centiseconds = static_cast<unsigned>(utc_us % 1000000 / 10000);
+  std::tm utc{};
+  gmtime_r(&seconds, &utc);
+  // 只有时间与日期，状态为 A（有效），定位、速度与航向字段为空
+  char body[64];
+  const int length =
+      std::snprintf(body, sizeof(body), "GPRMC,%02d%02d%02d.%02u,A,,,,,,,%02d%02d%02d,,,A", utc.tm_hour, utc.tm_min,
+                    utc.tm_sec, centiseconds, utc.tm_mday, utc.tm_mon + 1, utc.tm_year % 100);
+  uint8_t checksum = 0;
+  for (int i = 0; i < length; ++i) {
+    checksum ^= static_cast<uint8_t>(body[i]);
+  }
+  char sentence[80];
+  std::snprintf(sentence, sizeof(sentence), "$%s*%02X\r\n", body, checksum);
+  return sentence;
+}
+
+}  // namespace infinite_sense
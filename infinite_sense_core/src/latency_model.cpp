@@ -0,0 +1,149 @@
+#include "latency_model.h"
+#include "clock.h"
+#include "log.h"
+#include "messenger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace infinite_sense {
+namespace {
+constexpr size_t k_latency_min_samples = 32;
+// 每隔多少帧重新计算延迟下限
+constexpr size_t k_latency_refresh_frames = 32;
+// 延迟下限、上限取窗口内的分位数，预测时再留出的抖动余量
+constexpr double k_latency_floor_quantile = 0.05;
+constexpr double k_latency_ceil_quantile = 0.99;
+constexpr uint64_t k_latency_margin_us = 1000;
+constexpr uint64_t k_latency_publish_period_us = 1000000;
+// 超过这么久没有可学习的帧，已学到的分布视为失效
+constexpr uint64_t k_latency_stale_us = 2000000;
+
+size_t HistogramBin(const uint64_t value_us) {
+  size_t bin = value_us == 0 ? 0 : 1;
+  for (uint64_t v = value_us; v > 1 && bin < k_latency_histogram_bins - 1; v >>= 1) {
+    ++bin;
+  }
+  return bin;
+}
+
+double Percentile(const std::vector<uint64_t>& sorted, const double q) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const auto index = static_cast<size_t>(std::ceil(q * static_cast<double>(sorted.size()))) - 1;
+  return static_cast<double>(sorted[std::min(index, sorted.size() - 1)]);
+}
+}  // namespace
+
+CaptureLatencyModel::CaptureLatencyModel(const TriggerDevice dev, std::string name, const size_t window)
+    : dev_(dev), name_(std::move(name)), topic_(name_ + "_latency"), window_(std::max<size_t>(window, 1)) {}
+
+void CaptureLatencyModel::Record(const uint64_t arrival_us, const uint64_t trigger_us, const double exposure_us) {
+  exposure_us_ = exposure_us;
+  if (last_record_us_ != 0 && arrival_us > last_record_us_ + k_latency_stale_us) {
+    // 分布只由锁定后的帧学习，锁定长时间失效时它可能来自错误的锁定，丢弃后按先验范围重新对齐、学习
+    latencies_.clear();
+    since_refresh_ = 0;
+    floor_us_ = ceil_us_ = min_us_ = 0;
+  }
+  const TriggerWindow window = Window(arrival_us, exposure_us);
+  // 积压后集中取出的帧延迟远超分布上限，计入会撑大上限、使按时间关联的窗口失去唯一性
+  if (arrival_us >= trigger_us && (!Valid() || trigger_us >= window.locked_earliest_us)) {
+    const uint64_t latency = arrival_us - trigger_us;
+    min_us_ = latencies_.empty() ? static_cast<double>(latency) : std::min(min_us_, static_cast<double>(latency));
+    last_record_us_ = arrival_us;
+    latencies_.push_back(latency);
+    if (latencies_.size() > window_) {
+      latencies_.pop_front();
+    }
+    if (++since_refresh_ >= k_latency_refresh_frames) {
+      since_refresh_ = 0;
+      std::vector<uint64_t> sorted(latencies_.begin(), latencies_.end());
+      std::sort(sorted.begin(), sorted.end());
+      floor_us_ = Percentile(sorted, k_latency_floor_quantile);
+      ceil_us_ = Percentile(sorted, k_latency_ceil_quantile);
+    }
+  }
+  Poll();
+}
+
+bool CaptureLatencyModel::Valid() const { return latencies_.size() >= k_latency_min_samples && floor_us_ > 0; }
+
+TriggerWindow CaptureLatencyModel::Window(const uint64_t arrival_us, const double exposure_us) const {
+  const auto period_us = static_cast<double>(TriggerManger::GetInstance().GetTriggerPeriod(dev_));
+  const auto margin_us = static_cast<double>(k_latency_margin_us);
+  double min_us = exposure_us;
+  double max_us = exposure_us + period_us;
+  if (prior_max_us_ > 0) {
+    min_us = prior_min_us_;
+    max_us = prior_max_us_;
+  }
+  const bool learned = Valid() && arrival_us <= last_record_us_ + k_latency_stale_us;
+  if (learned) {
+    min_us = std::max(min_us, floor_us_ - margin_us);
+    max_us = std::max(min_us, ceil_us_ + margin_us);
+  }
+  const auto before = [arrival_us](const double delay_us) {
+    const auto delay = static_cast<uint64_t>(std::max(delay_us, 0.0));
+    return arrival_us > delay ? arrival_us - delay : 0;
+  };
+  TriggerWindow window;
+  window.arrival_us = arrival_us;
+  window.latest_us = before(min_us);
+  window.earliest_us = before(max_us);
+  window.locked_earliest_us = before(max_us + period_us / 2);
+  // 锁定后的上限只用于发现多出来的帧（触发序号 - 帧计数 变小，关联到晚一个周期的触发），取历史最小延迟
+  // 再放宽半个触发周期，比 延迟下限 - 余量 宽得多，偶尔偏快的帧不会破坏正确的锁定
+  window.locked_latest_us = learned ? before(std::max(exposure_us, min_us_ - period_us / 2)) : window.latest_us;
+  return window;
+}
+
+void CaptureLatencyModel::SetPriorRange(const double min_us, const double max_us) {
+  prior_min_us_ = std::max(min_us, 0.0);
+  prior_max_us_ = std::max(max_us, prior_min_us_);
+}
+
+CaptureLatency CaptureLatencyModel::GetLatency() const {
+  CaptureLatency latency{};
+  latency.time_stamp_us = HostClock::NowUs();
+  latency.samples = latencies_.size();
+  latency.exposure_us = exposure_us_;
+  std::vector<uint64_t> sorted(latencies_.begin(), latencies_.end());
+  std::sort(sorted.begin(), sorted.end());
+  for (const uint64_t value : sorted) {
+    ++latency.histogram[HistogramBin(value)];
+  }
+  latency.floor_us = Percentile(sorted, k_latency_floor_quantile);
+  latency.p50_us = Percentile(sorted, 0.50);
+  latency.p90_us = Percentile(sorted, 0.90);
+  latency.p99_us = Percentile(sorted, 0.99);
+  latency.max_us = sorted.empty() ? 0 : static_cast<double>(sorted.back());
+  latency.transfer_us = sorted.empty() ? 0 : latency.p50_us - exposure_us_;
+
+  latency.trigger_period_us = static_cast<double>(TriggerManger::GetInstance().GetTriggerPeriod(dev_));
+  return latency;
+}
+
+void CaptureLatencyModel::Poll() {
+  const uint64_t now = HostClock::NowUs();
+  if (last_publish_us_ != 0 && now - last_publish_us_ < k_latency_publish_period_us) {
+    return;
+  }
+  last_publish_us_ = now;
+  const CaptureLatency latency = GetLatency();
+  // 传输时间超过触发周期时图像在 SDK 缓存中越积越多，最终丢帧
+  const bool too_slow = latency.samples >= k_latency_min_samples && latency.trigger_period_us > 0 &&
+                        latency.transfer_us > latency.trigger_period_us;
+  if (too_slow && !transfer_warned_) {
+    LOG(WARNING) << name_ << " trigger-to-frame latency " << latency.p50_us << " us exceeds exposure "
+                 << latency.exposure_us << " us by more than the trigger period " << latency.trigger_period_us
+                 << " us, check GevSCPD and packet size";
+  }
+  transfer_warned_ = too_slow;
+  Messenger::GetInstance().PubStruct(topic_, &latency, sizeof(latency));
+}
+
+}  // namespace infinite_sense
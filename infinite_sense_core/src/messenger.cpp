@@ -38,6 +38,7 @@ void Messenger::CleanUp() {
 }
 
 void Messenger::Pub(const std::string& topic, const std::string& metadata) {
+  std::lock_guard lock(pub_lock_);
   try {
     publisher_.send(zmq::buffer(topic), zmq::send_flags::sndmore);
     publisher_.send(zmq::buffer(metadata), zmq::send_flags::dontwait);
@@ -47,6 +48,7 @@ void Messenger::Pub(const std::string& topic, const std::string& metadata) {
 }
 
 void Messenger::PubStruct(const std::string& topic, const void* data, const size_t size) {
+  std::lock_guard lock(pub_lock_);
   try {
     publisher_.send(zmq::buffer(topic), zmq::send_flags::sndmore);
     publisher_.send(zmq::buffer(data, size), zmq::send_flags::dontwait);
@@ -2,14 +2,13 @@
 #include "ptp.h"
 #include "data.h"
 #include "net.h"
+#include "clock.h"
 
 namespace infinite_sense {
 
 NetManager::NetManager(std::string target_ip, unsigned short port) : port_(port), target_ip_(std::move(target_ip)) {
   net_ptr_ = std::make_shared<UDPSocket>();
-  const uint64_t curr_time = static_cast<uint64_t>(
-      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
-          .count());
+  const uint64_t curr_time = HostClock::NowUs();
   net_ptr_->sendTo(reinterpret_cast<const uint8_t*>(&curr_time), sizeof(curr_time), target_ip_, port_);
   ptp_ = std::make_unique<Ptp>();
   ptp_->SetNetPtr(net_ptr_, target_ip_, port_);
@@ -47,38 +46,35 @@ void NetManager::Stop() {
   LOG(INFO) << "Net manager stopped";
 }
 
-void NetManager::Receive() const {
-  constexpr size_t k_buffer_size = 65536;
-  std::array<uint8_t, k_buffer_size> buffer{};
+void NetManager::Receive() {
   std::string source_address;
   unsigned short source_port = 0;
 
   while (started_) {
-    const int size = net_ptr_->recvFrom(buffer.data(), k_buffer_size, source_address, source_port);
+    const int size = net_ptr_->recvFrom(rx_buffer_.data(), rx_buffer_.size(), source_address, source_port);
     if (size <= 0) {
       std::this_thread::sleep_for(std::chrono::milliseconds(1));
       continue;
     }
+    if (recorder_) {
+      recorder_->Write(RawSource::NET, HostClock::NowNs(), rx_buffer_.data(), size);
+    }
+    HandlePacket(rx_buffer_.data(), size);
+  }
+}
 
-    try {
-      std::string recv_data(reinterpret_cast<char*>(buffer.data()), size);
-      if (recv_data.empty()) {
-        continue;
-      }
-      auto json_data = nlohmann::json::parse(recv_data, nullptr, false);
-      if (json_data.is_discarded()) {
-        LOG(WARNING) << "Received malformed JSON";
-        continue;
-      }
-      ptp_->ReceivePtpData(json_data);
-      ProcessTriggerData(json_data);
-      ProcessIMUData(json_data);
-      ProcessGPSData(json_data);
-      ProcessLOGData(json_data);
-
-    } catch (const std::exception& e) {
-      LOG(ERROR) << "Exception during JSON handling: " << e.what();
+void NetManager::HandlePacket(const uint8_t* data, const size_t size) const {
+  try {
+    // 直接在接收缓冲区上解析，不再拷贝到中间 std::string
+    auto json_data = nlohmann::json::parse(data, data + size, nullptr, false);
+    if (json_data.is_discarded()) {
+      LOG(WARNING) << "Received malformed JSON";
+      return;
     }
+    ptp_->ReceivePtpData(json_data);
+    ProcessDeviceMessage(json_data);
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Exception during JSON handling: " << e.what();
   }
 }
 
@@ -86,7 +82,12 @@ void NetManager::TimeStampSynchronization() const {
   while (started_) {
     try {
       ptp_->SendPtpData();
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));  // 限制频率，防止死循环占满 CPU
+      ptp_->PublishSyncQuality();
+      // 按 Ptp 给出的自适应间隔等待，分片睡眠以便及时响应 Stop
+      const auto next = std::chrono::steady_clock::now() + ptp_->NextSyncInterval();
+      while (started_ && std::chrono::steady_clock::now() < next) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
     } catch (const std::exception& e) {
       LOG(ERROR) << "Timestamp sync error: " << e.what();
     }
@@ -1,8 +1,13 @@
 #include "ptp.h"
 #include "usb.h"
 #include "log.h"
-#include <thread>
+#include "clock.h"
+#include "messenger.h"
+#include "time_translator.h"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdlib>
 
 namespace infinite_sense {
 
@@ -10,6 +15,25 @@ constexpr char func_name[] = "f";
 constexpr char func_type_a[] = "a";
 constexpr char func_type_b[] = "b";
 
+// 交换节奏：突发 -> 基础间隔 -> 稳定后逐步加倍到最大间隔
+constexpr int k_burst_exchanges = 16;
+constexpr int64_t k_burst_interval_ms = 20;
+constexpr int64_t k_base_interval_ms = 100;
+constexpr int64_t k_max_interval_ms = 1000;
+constexpr int64_t k_jump_threshold_us = 1000;
+constexpr double k_stable_offset_us = 100;
+constexpr size_t k_stable_samples = 8;
+
+// 保持状态：超过若干交换周期没有收到交换即认为链路中断
+constexpr int64_t k_holdover_periods = 3;
+constexpr int64_t k_holdover_min_ms = 500;
+constexpr double k_holdover_drift_ppm = 2.0;
+
+constexpr char k_sync_quality_topic[] = "sync_quality";
+constexpr uint64_t k_sync_quality_period_us = 1000000;
+
+Ptp::Ptp() : burst_remaining_(k_burst_exchanges), interval_ms_(k_burst_interval_ms) {}
+
 void Ptp::SetUsbPtr(const std::shared_ptr<serial::Serial>& serial_ptr) { serial_ptr_ = serial_ptr; }
 
 void Ptp::SetNetPtr(const std::shared_ptr<UDPSocket>& net_ptr, const std::string& target_ip,
@@ -37,6 +61,7 @@ void Ptp::HandleTimeSyncRequest(const nlohmann::json& data) {
   try {
     time_t1_ = data.at(func_type_a);
     time_t2_ = data.at(func_type_b);
+    a_recv_ns_ = HostClock::NowNs();
     updated_t1_t2_ = true;
   } catch (const nlohmann::json::exception& e) {
     LOG(ERROR) << "Invalid 'a' message format: " << e.what();
@@ -46,11 +71,32 @@ void Ptp::HandleTimeSyncRequest(const nlohmann::json& data) {
 void Ptp::HandleTimeSyncResponse(const nlohmann::json& data) {
   try {
     const uint64_t t3 = data.at(func_type_a);
-    const uint64_t t4 = GetCurrentTimeUs();
+    const uint64_t b_recv_ns = HostClock::NowNs();
+    const uint64_t t4 = b_recv_ns / 1000;
 
     if (updated_t1_t2_) {
       const int64_t delay = static_cast<int64_t>(t4 - t3 + time_t2_ - time_t1_) / 2;
       const int64_t offset = static_cast<int64_t>(time_t2_ - time_t1_ - t4 + t3) / 2;
+      updated_t1_t2_ = false;
+
+      // 链路是否中断只看是否收到交换，与过滤结果无关；过滤器拒绝率高时不应误入保持状态
+      if (GetSyncState() == SYNC_HOLDOVER) {
+        LOG(INFO) << "Time sync link restored after " << (t4 - last_sync_us_) / 1000 << " ms, bursting time sync";
+        burst_remaining_ = k_burst_exchanges;
+        interval_ms_ = k_burst_interval_ms;
+      }
+      holdover_after_us_ = t4 + std::max(k_holdover_periods * interval_ms_, k_holdover_min_ms) * 1000;
+
+      // 延迟偏大的交换多半是主机线程被抢占，偏差不可信，既不下发也不参与估计
+      const bool accepted = rtt_filter_.Accept(delay);
+      monitor_.Record(delay, offset, accepted);
+      if (exchange_log_) {
+        exchange_log_->Write({time_t1_, time_t2_, t3, t4, a_recv_ns_, b_recv_ns, accepted ? offset : 0,
+                              static_cast<uint8_t>(accepted)});
+      }
+      if (!accepted) {
+        return;
+      }
 
       const nlohmann::json response = {
           {func_name, func_type_b},
@@ -58,8 +104,12 @@ void Ptp::HandleTimeSyncResponse(const nlohmann::json& data) {
           {func_type_b, offset},
       };
 
+      estimator_.AddSample(time_t1_ + (t4 - time_t1_) / 2, offset);
       SendJson(response);
-      updated_t1_t2_ = false;
+      estimator_.ApplyCorrection(offset);
+      TimeTranslator::GetInstance().Update(estimator_.GetModel());
+      UpdateSchedule(offset);
+      last_sync_us_ = t4;
     }
   } catch (const nlohmann::json::exception& e) {
     LOG(ERROR) << "Invalid 'b' message format: " << e.what();
@@ -75,7 +125,73 @@ void Ptp::SendPtpData() const {
   };
 
   SendJson(data);
-  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+void Ptp::UpdateSchedule(const int64_t offset) {
+  if (std::llabs(offset) > k_jump_threshold_us) {
+    // 检测到时钟跳变（同步板复位或首次同步），重新突发以快速收敛
+    if (burst_remaining_ == 0) {
+      LOG(INFO) << "Clock jump of " << offset << " us detected, bursting time sync";
+    }
+    burst_remaining_ = k_burst_exchanges;
+  }
+  if (burst_remaining_ > 0) {
+    --burst_remaining_;
+    interval_ms_ = k_burst_interval_ms;
+    return;
+  }
+  const ClockModel model = estimator_.GetModel();
+  const bool stable = model.samples >= k_stable_samples && std::abs(static_cast<double>(offset)) <= k_stable_offset_us &&
+                      model.residual_us <= k_stable_offset_us;
+  interval_ms_ = stable ? std::min(interval_ms_ * 2, k_max_interval_ms) : k_base_interval_ms;
+}
+
+std::chrono::milliseconds Ptp::NextSyncInterval() const {
+  // 保持状态下以基础间隔探测链路是否恢复
+  if (GetSyncState() == SYNC_HOLDOVER) {
+    return std::chrono::milliseconds(std::min(interval_ms_.load(), k_base_interval_ms));
+  }
+  return std::chrono::milliseconds(interval_ms_.load());
+}
+
+SyncState Ptp::GetSyncState() const {
+  if (last_sync_us_ == 0) {
+    return SYNC_NONE;
+  }
+  return GetCurrentTimeUs() > holdover_after_us_ ? SYNC_HOLDOVER : SYNC_LOCKED;
+}
+
+double Ptp::GetUncertaintyUs() const {
+  const uint64_t last_sync = last_sync_us_;
+  if (last_sync == 0) {
+    return 0;
+  }
+  const double elapsed_us = static_cast<double>(GetCurrentTimeUs() - last_sync);
+  return estimator_.GetModel().residual_us + k_holdover_drift_ppm * 1e-6 * elapsed_us;
+}
+
+SyncQuality Ptp::GetSyncQuality() const {
+  const uint64_t now = GetCurrentTimeUs();
+  SyncQuality quality = monitor_.Snapshot(now, estimator_.GetModel(), rtt_filter_.GetStats());
+  quality.state = GetSyncState();
+  quality.uncertainty_us = GetUncertaintyUs();
+  const uint64_t last_sync = last_sync_us_;
+  quality.since_sync_us = last_sync == 0 ? 0 : now - last_sync;
+  return quality;
+}
+
+void Ptp::PublishSyncQuality() {
+  const uint64_t now = GetCurrentTimeUs();
+  if (last_publish_us_ != 0 && now - last_publish_us_ < k_sync_quality_period_us) {
+    return;
+  }
+  last_publish_us_ = now;
+  const SyncQuality quality = GetSyncQuality();
+  if (quality.state == SYNC_HOLDOVER && published_state_ != SYNC_HOLDOVER) {
+    LOG(WARNING) << "Time sync link lost, entering holdover with " << quality.skew_ppm << " ppm drift model";
+  }
+  published_state_ = static_cast<SyncState>(quality.state);
+  Messenger::GetInstance().PubStruct(k_sync_quality_topic, &quality, sizeof(quality));
 }
 
 void Ptp::SendJson(const nlohmann::json& data) const {
@@ -90,9 +206,6 @@ void Ptp::SendJson(const nlohmann::json& data) const {
   }
 }
 
-uint64_t Ptp::GetCurrentTimeUs() {
-  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
-      .count();
-}
+uint64_t Ptp::GetCurrentTimeUs() { return HostClock::NowUs(); }
 
 }  // namespace infinite_sense
@@ -0,0 +1,162 @@
+#include "raw_frame.h"
+
+#include <cstring>
+#include <utility>
+
+namespace infinite_sense {
+namespace {
+// 交换一行的 R、B 通道
+void SwapRedBlueRow(const uint8_t *src, uint8_t *dst, const int width) {
+  for (int x = 0; x < width; ++x) {
+    dst[3 * x] = src[3 * x + 2];
+    dst[3 * x + 1] = src[3 * x + 1];
+    dst[3 * x + 2] = src[3 * x];
+  }
+}
+}  // namespace
+
+RawFrame::RawFrame(const uint64_t time_stamp_us, const bool triggered, std::string name, const RawFormat &format,
+                   const uint8_t *data, const size_t size)
+    : time_stamp_us_(time_stamp_us),
+      triggered_(triggered),
+      name_(std::move(name)),
+      format_(format),
+      data_(data, data + size) {}
+
+bool RawFrame::Valid() const {
+  if (format_.width <= 0 || format_.height <= 0) {
+    return false;
+  }
+  // Bayer 的行长度由 DemosaicBayer 按位深检查
+  const auto width = static_cast<size_t>(format_.width);
+  size_t row_bytes = 0;
+  if (format_.pixel == PixelFormat::MONO8) {
+    row_bytes = width;
+  } else if (format_.pixel == PixelFormat::BGR8 || format_.pixel == PixelFormat::RGB8) {
+    row_bytes = width * 3;
+  }
+  return format_.stride >= row_bytes && format_.stride * static_cast<size_t>(format_.height) <= data_.size();
+}
+
+BayerImage RawFrame::ToBayerImage() const {
+  BayerImage image;
+  image.data = data_.data();
+  image.width = format_.width;
+  image.height = format_.height;
+  image.stride = format_.stride;
+  image.pattern = format_.pattern;
+  image.bit_depth = format_.bit_depth;
+  image.packed = format_.packed;
+  return image;
+}
+
+const GMat &RawFrame::Bgr() const {
+  std::call_once(bgr_once_, [this] {
+    if (!Valid()) {
+      return;
+    }
+    const int width = format_.width;
+    const int height = format_.height;
+    GMat image(height, width, GMatType<uint8_t, 3>::Type);
+    const size_t dst_stride = static_cast<size_t>(width) * 3;
+    bool converted = true;
+    switch (format_.pixel) {
+      case PixelFormat::BAYER:
+        converted = DemosaicBayer(ToBayerImage(), image.data, dst_stride);
+        break;
+      case PixelFormat::BGR8:
+        for (int y = 0; y < height; ++y) {
+          std::memcpy(image.data + y * dst_stride, data_.data() + y * format_.stride, dst_stride);
+        }
+        break;
+      case PixelFormat::RGB8:
+        for (int y = 0; y < height; ++y) {
+          SwapRedBlueRow(data_.data() + y * format_.stride, image.data + y * dst_stride, width);
+        }
+        break;
+      case PixelFormat::MONO8:
+        for (int y = 0; y < height; ++y) {
+          const uint8_t *src = data_.data() + y * format_.stride;
+          uint8_t *dst = image.data + y * dst_stride;
+          for (int x = 0; x < width; ++x) {
+            dst[3 * x] = dst[3 * x + 1] = dst[3 * x + 2] = src[x];
+          }
+        }
+        break;
+    }
+    if (converted) {
+      bgr_ = image;
+    }
+  });
+  return bgr_;
+}
+
+const GMat &RawFrame::Gray() const {
+  std::call_once(gray_once_, [this] {
+    if (!Valid()) {
+      return;
+    }
+    const int width = format_.width;
+    const int height = format_.height;
+    GMat image(height, width, GMatType<uint8_t, 1>::Type);
+    const auto dst_stride = static_cast<size_t>(width);
+    bool converted = true;
+    switch (format_.pixel) {
+      case PixelFormat::BAYER:
+        converted = BayerToGray(ToBayerImage(), image.data, dst_stride);
+        break;
+      case PixelFormat::BGR8:
+        for (int y = 0; y < height; ++y) {
+          BgrToGrayRow(data_.data() + y * format_.stride, image.data + y * dst_stride, width);
+        }
+        break;
+      case PixelFormat::RGB8: {
+        std::vector<uint8_t> bgr(static_cast<size_t>(width) * 3);
+        for (int y = 0; y < height; ++y) {
+          SwapRedBlueRow(data_.data() + y * format_.stride, bgr.data(), width);
+          BgrToGrayRow(bgr.data(), image.data + y * dst_stride, width);
+        }
+        break;
+      }
+      case PixelFormat::MONO8:
+        for (int y = 0; y < height; ++y) {
+          std::memcpy(image.data + y * dst_stride, data_.data() + y * format_.stride, dst_stride);
+        }
+        break;
+    }
+    if (converted) {
+      gray_ = image;
+    }
+  });
+  return gray_;
+}
+
+void RawFrameHub::Subscribe(const std::string &name, RawFrameCallback callback) {
+  std::lock_guard lock(lock_);
+  callbacks_[name].push_back(std::move(callback));
+}
+
+bool RawFrameHub::HasSubscribers(const std::string &name) const {
+  std::lock_guard lock(lock_);
+  return callbacks_.find(name) != callbacks_.end();
+}
+
+void RawFrameHub::Publish(const std::shared_ptr<const RawFrame> &frame) const {
+  if (!frame) {
+    return;
+  }
+  std::vector<RawFrameCallback> callbacks;
+  {
+    std::lock_guard lock(lock_);
+    const auto it = callbacks_.find(frame->Name());
+    if (it == callbacks_.end()) {
+      return;
+    }
+    callbacks = it->second;
+  }
+  for (const auto &callback : callbacks) {
+    callback(frame);
+  }
+}
+
+}  // namespace infinite_sense
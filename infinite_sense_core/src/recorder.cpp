@@ -0,0 +1,77 @@
+#include "recorder.h"
+#include "log.h"
+
+namespace infinite_sense {
+
+RawRecorder::RawRecorder(const std::string& path) {
+  file_ = std::fopen(path.c_str(), "wb");
+  if (!file_) {
+    LOG(ERROR) << "Failed to open raw record file: " << path;
+    return;
+  }
+  std::setvbuf(file_, nullptr, _IOFBF, 1 << 20);
+  std::fwrite(k_raw_record_magic, sizeof(k_raw_record_magic), 1, file_);
+  LOG(INFO) << "Recording raw device stream to " << path;
+}
+
+RawRecorder::~RawRecorder() {
+  if (file_) {
+    std::fclose(file_);
+    file_ = nullptr;
+    LOG(INFO) << "Raw recorder closed, " << records_ << " records written";
+  }
+}
+
+void RawRecorder::Write(const RawSource source, const uint64_t host_time_ns, const void* data, const size_t size) {
+  if (!file_) {
+    return;
+  }
+  const RawRecordHeader header{host_time_ns, static_cast<uint8_t>(source), static_cast<uint32_t>(size)};
+  std::lock_guard lock(lock_);
+  std::fwrite(&header, sizeof(header), 1, file_);
+  std::fwrite(data, 1, size, file_);
+  ++records_;
+}
+
+void RawRecorder::Flush() {
+  std::lock_guard lock(lock_);
+  if (file_) {
+    std::fflush(file_);
+  }
+}
+
+PtpExchangeLog::PtpExchangeLog(const std::string& path) {
+  file_ = std::fopen(path.c_str(), "wb");
+  if (!file_) {
+    LOG(ERROR) << "Failed to open PTP exchange log: " << path;
+    return;
+  }
+  std::fwrite(k_ptp_log_magic, sizeof(k_ptp_log_magic), 1, file_);
+  LOG(INFO) << "Logging PTP exchanges to " << path;
+}
+
+PtpExchangeLog::~PtpExchangeLog() {
+  if (file_) {
+    std::fclose(file_);
+    file_ = nullptr;
+    LOG(INFO) << "PTP exchange log closed, " << records_ << " exchanges written";
+  }
+}
+
+void PtpExchangeLog::Write(const PtpExchangeRecord& record) {
+  if (!file_) {
+    return;
+  }
+  std::lock_guard lock(lock_);
+  std::fwrite(&record, sizeof(record), 1, file_);
+  ++records_;
+}
+
+void PtpExchangeLog::Flush() {
+  std::lock_guard lock(lock_);
+  if (file_) {
+    std::fflush(file_);
+  }
+}
+
+}  // namespace infinite_sense
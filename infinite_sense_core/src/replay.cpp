@@ -0,0 +1,104 @@
+#include "replay.h"
+#include "infinite_sense.h"
+#include "ptp.h"
+#include "data.h"
+
+#include <chrono>
+#include <fstream>
+#include <vector>
+
+namespace infinite_sense {
+
+ReplayManager::ReplayManager(std::string path, const double speed)
+    : path_(std::move(path)), speed_(speed), ptp_(std::make_shared<Ptp>()) {}
+
+ReplayManager::~ReplayManager() { Stop(); }
+
+void ReplayManager::Start() {
+  if (started_) {
+    return;
+  }
+  started_ = true;
+  finished_ = false;
+  replay_thread_ = std::thread(&ReplayManager::Replay, this);
+  LOG(INFO) << "Replay manager started: " << path_;
+}
+
+void ReplayManager::Stop() {
+  if (!started_) {
+    return;
+  }
+  started_ = false;
+  if (replay_thread_.joinable()) {
+    replay_thread_.join();
+  }
+  LOG(INFO) << "Replay manager stopped";
+}
+
+void ReplayManager::Replay() {
+  std::ifstream in(path_, std::ios::binary);
+  char magic[sizeof(k_raw_record_magic)]{};
+  if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), k_raw_record_magic)) {
+    LOG(ERROR) << "Invalid raw record file: " << path_;
+    finished_ = true;
+    return;
+  }
+
+  std::vector<char> data;
+  std::string pending;  // 串口字节流按行拼接
+  uint64_t first_time_ns = 0;
+  uint64_t records = 0;
+  const auto start = std::chrono::steady_clock::now();
+
+  RawRecordHeader header{};
+  while (started_ && in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    data.resize(header.length);
+    if (!in.read(data.data(), header.length)) {
+      LOG(WARNING) << "Raw record file truncated after " << records << " records";
+      break;
+    }
+    if (records++ == 0) {
+      first_time_ns = header.host_time_ns;
+    }
+    if (speed_ > 0) {
+      const auto offset = std::chrono::nanoseconds(
+          static_cast<int64_t>(static_cast<double>(header.host_time_ns - first_time_ns) / speed_));
+      std::this_thread::sleep_until(start + offset);
+    }
+
+    // 同步质量由链路的时间同步线程周期发布，回放没有该线程，在回放线程中发布
+    ptp_->PublishSyncQuality();
+    if (header.source == static_cast<uint8_t>(RawSource::NET)) {
+      HandleMessage(data.data(), data.size());
+      continue;
+    }
+    pending.append(data.data(), data.size());
+    size_t begin = 0;
+    for (size_t end = pending.find('\n'); end != std::string::npos; end = pending.find('\n', begin)) {
+      if (end > begin) {
+        HandleMessage(pending.data() + begin, end - begin);
+      }
+      begin = end + 1;
+    }
+    pending.erase(0, begin);
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  LOG(INFO) << "Replay finished: " << records << " records in " << seconds << " s";
+  finished_ = true;
+}
+
+void ReplayManager::HandleMessage(const char* data, const size_t size) const {
+  try {
+    auto json_data = nlohmann::json::parse(data, data + size, nullptr, false);
+    if (json_data.is_discarded()) {
+      LOG(WARNING) << "Replayed malformed JSON";
+      return;
+    }
+    ptp_->ReceivePtpData(json_data);
+    ProcessDeviceMessage(json_data);
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Exception during JSON handling: " << e.what();
+  }
+}
+
+}  // namespace infinite_sense
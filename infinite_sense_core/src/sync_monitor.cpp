@@ -0,0 +1,85 @@
+#include "sync_monitor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace infinite_sense {
+namespace {
+size_t HistogramBin(const int64_t value_us) {
+  const auto magnitude = static_cast<uint64_t>(std::llabs(value_us));
+  if (magnitude == 0) {
+    return 0;
+  }
+  size_t bin = 1;
+  for (uint64_t v = magnitude; v > 1 && bin < k_sync_histogram_bins - 1; v >>= 1) {
+    ++bin;
+  }
+  return bin;
+}
+
+int64_t Percentile(const std::vector<int64_t>& sorted, const double q) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const auto index = static_cast<size_t>(std::ceil(q * static_cast<double>(sorted.size()))) - 1;
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+}  // namespace
+
+SyncMonitor::SyncMonitor(const size_t window) : window_(std::max<size_t>(window, 1)) {}
+
+void SyncMonitor::Record(const int64_t delay_us, const int64_t offset_us, const bool accepted) {
+  std::lock_guard lock(lock_);
+  exchanges_.push_back({delay_us * 2, offset_us, accepted});
+  if (exchanges_.size() > window_) {
+    exchanges_.pop_front();
+  }
+  if (accepted) {
+    last_offset_us_ = offset_us;
+  }
+}
+
+SyncQuality SyncMonitor::Snapshot(const uint64_t now_us, const ClockModel& model,
+                                  const RttFilterStats& filter) const {
+  SyncQuality quality{};
+  quality.time_stamp_us = now_us;
+  quality.valid = model.valid;
+  quality.model_offset_us = model.valid ? model.OffsetAt(now_us) : 0;
+  quality.skew_ppm = model.skew_ppm;
+  quality.residual_us = model.residual_us;
+  quality.exchanges = filter.exchanges;
+  quality.rejected = filter.rejected;
+
+  std::vector<int64_t> rtts;
+  {
+    std::lock_guard lock(lock_);
+    quality.last_offset_us = last_offset_us_;
+    rtts.reserve(exchanges_.size());
+    for (const auto& exchange : exchanges_) {
+      rtts.push_back(exchange.rtt_us);
+      ++quality.rtt_histogram[HistogramBin(exchange.rtt_us)];
+      if (exchange.accepted) {
+        ++quality.offset_histogram[HistogramBin(exchange.offset_us)];
+      } else {
+        ++quality.window_rejected;
+      }
+    }
+  }
+  quality.window_exchanges = static_cast<uint32_t>(rtts.size());
+  std::sort(rtts.begin(), rtts.end());
+  quality.rtt_p50_us = Percentile(rtts, 0.50);
+  quality.rtt_p90_us = Percentile(rtts, 0.90);
+  quality.rtt_p99_us = Percentile(rtts, 0.99);
+  quality.rtt_max_us = rtts.empty() ? 0 : rtts.back();
+  return quality;
+}
+
+void SyncMonitor::Reset() {
+  std::lock_guard lock(lock_);
+  exchanges_.clear();
+  last_offset_us_ = 0;
+}
+
+}  // namespace infinite_sense
@@ -0,0 +1,29 @@
+#include "time_translator.h"
+
+namespace infinite_sense {
+
+void TimeTranslator::Update(const ClockModel& model) {
+  if (!model.valid) {
+    return;
+  }
+  Store(model.ref_host_us, model.offset_us, model.skew_ppm);
+  valid_.store(true, std::memory_order_relaxed);
+}
+
+void TimeTranslator::Reset() {
+  Store(0, 0, 0);
+  valid_.store(false, std::memory_order_relaxed);
+}
+
+void TimeTranslator::Store(const uint64_t ref_host_us, const double offset_us, const double skew_ppm) {
+  std::lock_guard lock(write_lock_);
+  const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+  sequence_.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  ref_host_us_.store(ref_host_us, std::memory_order_relaxed);
+  offset_us_.store(offset_us, std::memory_order_relaxed);
+  skew_ppm_.store(skew_ppm, std::memory_order_relaxed);
+  sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+}  // namespace infinite_sense
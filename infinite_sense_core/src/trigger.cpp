@@ -1,65 +1,280 @@
 #include "trigger.h"
+#include "clock.h"
+
+#include <algorithm>
+#include <limits>
 
 namespace infinite_sense {
 
-std::map<TriggerDevice, std::string> device_map_topics{
-    {IMU_1, "imu_1_trigger"},
-    {IMU_2, "imu_2_trigger"},
-    {CAM_1, "cam_1_trigger"},
-    {CAM_2, "cam_2_trigger"},
-    {CAM_3, "cam_3_trigger"},
-    {CAM_4, "cam_4_trigger"},
-    {LASER, "laser_trigger"},
-    {GPS, "gps_trigger"}};
+namespace {
+constexpr char k_trigger_topic[] = "trigger";
+// 间隔超过标称周期的这一倍数才判定为丢失
+constexpr uint64_t k_lost_ratio_num = 3;
+constexpr uint64_t k_lost_ratio_den = 2;
+// 超过这么多个周期的间隔视为触发暂停或同步板时钟跳变，不计为丢失
+constexpr uint64_t k_lost_max_periods = 64;
+// 长间隔之差不超过最短者的这一分之一时视为彼此一致
+constexpr uint64_t k_rate_agree_den = 8;
+
+// 默认通道名称，下标即通道序号
+const std::array<const char*, 16> k_default_channel_names{
+    "imu_1", "imu_2", "cam_1", "cam_2", "cam_3",   "cam_4",   "laser",   "gps",
+    "cam_5", "cam_6", "cam_7", "cam_8", "lidar_1", "lidar_2", "lidar_3", "lidar_4"};
+
+size_t LowestSetBit(const uint64_t mask) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward64(&index, mask);
+  return index;
+#else
+  return static_cast<size_t>(__builtin_ctzll(mask));
+#endif
+}
+}  // namespace
 
 TriggerManger::TriggerManger() {
-  uint64_t time = std::numeric_limits<uint64_t>::max();
-  const std::tuple<bool, uint64_t> empty = std::tuple(0, time);
-  status_map_[IMU_1] = empty;
-  status_map_[IMU_2] = empty;
-  status_map_[CAM_1] = empty;
-  status_map_[CAM_2] = empty;
-  status_map_[CAM_3] = empty;
-  status_map_[CAM_4] = empty;
-  status_map_[LASER] = empty;
-  status_map_[GPS] = empty;
-}
-void TriggerManger::SetLastTriggerStatus(const uint64_t& time, const uint8_t& status) {
-  std::lock_guard lock(lock_);
-  status_ = status;
-  UpdateAndPublishDevice(IMU_1, 0, time);
-  UpdateAndPublishDevice(IMU_2, 1, time);
-  UpdateAndPublishDevice(CAM_1, 2, time);
-  UpdateAndPublishDevice(CAM_2, 3, time);
-  UpdateAndPublishDevice(CAM_3, 4, time);
-  UpdateAndPublishDevice(CAM_4, 5, time);
-  UpdateAndPublishDevice(LASER, 6, time);
-  UpdateAndPublishDevice(GPS, 7, time);
-}
-
-bool TriggerManger::GetLastTriggerStatus(const TriggerDevice dev, uint64_t& time) {
-  std::lock_guard lock(lock_);
-  if (status_map_.find(dev) == status_map_.end()) {
+  for (size_t i = 0; i < k_trigger_channel_count; ++i) {
+    topics_[i] = (i < k_default_channel_names.size() ? std::string(k_default_channel_names[i])
+                                                     : "channel_" + std::to_string(i)) +
+                 "_trigger";
+  }
+}
+
+uint64_t TriggerHistory::Push(const TriggerEvent& event) {
+  const size_t head = head_.load(std::memory_order_relaxed);
+  const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+  sequence_.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slots_[head].time_us.store(event.time_us, std::memory_order_relaxed);
+  slots_[head].seq.store(event.seq, std::memory_order_relaxed);
+  slots_[head].host_ns.store(event.host_ns, std::memory_order_relaxed);
+  const uint64_t index = next_index_++;
+  slots_[head].index.store(index, std::memory_order_relaxed);
+  head_.store((head + 1) % k_capacity, std::memory_order_relaxed);
+  size_.store(std::min(size_.load(std::memory_order_relaxed) + 1, k_capacity), std::memory_order_relaxed);
+  sequence_.store(sequence + 2, std::memory_order_release);
+
+  // 同步板复位时触发时间回退，不参与周期估计
+  if (index > 0 && event.time_us > last_time_us_) {
+    const uint64_t interval = event.time_us - last_time_us_;
+    const uint64_t period = period_us_.load(std::memory_order_relaxed);
+    if (period > 0 && interval * k_lost_ratio_den > period * k_lost_ratio_num &&
+        interval <= period * k_lost_max_periods) {
+      // 长间隔先保留：之后出现正常间隔才是丢包，连续一致则是触发频率降低
+      long_intervals_[long_count_++] = interval;
+      const auto begin = long_intervals_.begin();
+      const auto end = begin + static_cast<std::ptrdiff_t>(long_count_);
+      if (long_count_ == k_rate_change_intervals) {
+        const uint64_t shortest = *std::min_element(begin, end);
+        if ((*std::max_element(begin, end) - shortest) * k_rate_agree_den <= shortest) {
+          LOG(INFO) << "Trigger period changed from " << period << " us to " << shortest << " us";
+          interval_count_ = 0;
+          std::for_each(begin, end, [this](const uint64_t value) { AddInterval(value); });
+          long_count_ = 0;
+        } else {
+          CountLost(period);
+        }
+      }
+    } else {
+      CountLost(period);
+      AddInterval(interval);
+    }
+  }
+  last_time_us_ = event.time_us;
+  return index;
+}
+
+void TriggerHistory::AddInterval(const uint64_t interval) {
+  // 丢包只会让间隔变长，取最小值作为标称周期
+  intervals_[interval_count_++ % k_period_window] = interval;
+  const auto end = intervals_.begin() + static_cast<std::ptrdiff_t>(std::min(interval_count_, k_period_window));
+  period_us_.store(*std::min_element(intervals_.begin(), end), std::memory_order_relaxed);
+}
+
+void TriggerHistory::CountLost(const uint64_t period) {
+  uint64_t lost = 0;
+  for (size_t i = 0; i < long_count_; ++i) {
+    lost += (long_intervals_[i] + period / 2) / period - 1;
+  }
+  long_count_ = 0;
+  if (lost > 0) {
+    lost_.fetch_add(lost, std::memory_order_relaxed);
+  }
+}
+
+TriggerEvent TriggerHistory::Recent(const size_t head, const size_t i) const {
+  const Slot& slot = slots_[(head + k_capacity - 1 - i) % k_capacity];
+  return {slot.time_us.load(std::memory_order_relaxed), slot.seq.load(std::memory_order_relaxed),
+          slot.host_ns.load(std::memory_order_relaxed), slot.index.load(std::memory_order_relaxed)};
+}
+
+bool TriggerHistory::Latest(TriggerEvent& event) const {
+  bool found = false;
+  Read([&](const size_t head, const size_t size) {
+    found = size > 0;
+    if (found) {
+      event = Recent(head, 0);
+    }
+  });
+  return found;
+}
+
+bool TriggerHistory::FindBySeq(const uint64_t seq, TriggerEvent& event) const {
+  bool found = false;
+  Read([&](const size_t head, const size_t size) {
+    found = false;
+    for (size_t i = 0; i < size; ++i) {
+      if (const TriggerEvent recent = Recent(head, i); recent.seq == seq) {
+        event = recent;
+        found = true;
+        return;
+      }
+    }
+  });
+  return found;
+}
+
+bool TriggerHistory::FindByIndex(const uint64_t index, TriggerEvent& event) const {
+  bool found = false;
+  Read([&](const size_t head, const size_t size) {
+    found = false;
+    if (size == 0) {
+      return;
+    }
+    // 序号连续递增，直接由与最新事件的序号差定位
+    const uint64_t newest = Recent(head, 0).index;
+    if (index <= newest && newest - index < size) {
+      event = Recent(head, static_cast<size_t>(newest - index));
+      found = true;
+    }
+  });
+  return found;
+}
+
+bool TriggerHistory::FindBefore(const uint64_t time_us, TriggerEvent& event) const {
+  bool found = false;
+  // 从最新的事件向前查找，通常只需比较几次
+  Read([&](const size_t head, const size_t size) {
+    found = false;
+    for (size_t i = 0; i < size; ++i) {
+      if (const TriggerEvent recent = Recent(head, i); recent.time_us <= time_us) {
+        event = recent;
+        found = true;
+        return;
+      }
+    }
+  });
+  return found;
+}
+
+void TriggerHistory::FindRange(const uint64_t begin_us, const uint64_t end_us,
+                               std::vector<TriggerEvent>& events) const {
+  const size_t offset = events.size();
+  Read([&](const size_t head, const size_t size) {
+    events.resize(offset);
+    for (size_t i = size; i-- > 0;) {
+      if (const TriggerEvent recent = Recent(head, i); recent.time_us >= begin_us && recent.time_us <= end_us) {
+        events.push_back(recent);
+      }
+    }
+  });
+}
+
+void TriggerManger::SetLastTriggerStatus(const uint64_t& time, const TriggerMask& status, const uint64_t seq) {
+  const TriggerEvent event{time, seq, HostClock::NowNs()};
+  // 只遍历置位的通道，通道数增加不影响每次触发的开销
+  const uint64_t mask = status.to_ullong();
+  TriggerMessage message;
+  message.time_stamp_us = time;
+  message.host_ns = event.host_ns;
+  message.seq = seq;
+  message.mask = mask;
+  message.count = 0;
+  {
+    std::lock_guard lock(write_lock_);
+    for (uint64_t bits = mask; bits != 0; bits &= bits - 1) {
+      message.index[message.count++] = histories_[LowestSetBit(bits)].Push(event);
+    }
+  }
+  // 发布在锁外进行，订阅者的处理时间不会阻塞其它写入
+  try {
+    Messenger::GetInstance().PubStruct(k_trigger_topic, &message, message.Size());
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to publish trigger message: " << e.what();
+  }
+  if (!channel_topics_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  for (uint64_t bits = mask; bits != 0; bits &= bits - 1) {
+    PublishDeviceStatus(static_cast<TriggerDevice>(LowestSetBit(bits)), time, true);
+  }
+}
+
+void TriggerManger::SetChannelName(const TriggerDevice dev, const std::string& name) {
+  if (static_cast<size_t>(dev) >= k_trigger_channel_count) {
+    LOG(ERROR) << "Trigger channel " << dev << " out of range, max " << k_trigger_channel_count;
+    return;
+  }
+  topics_[dev] = name + "_trigger";
+}
+
+const std::string& TriggerManger::GetChannelTopic(const TriggerDevice dev) const { return topics_.at(dev); }
+
+bool TriggerManger::GetLastTriggerStatus(const TriggerDevice dev, uint64_t& time) const {
+  if (static_cast<size_t>(dev) >= k_trigger_channel_count) {
+    return false;
+  }
+  TriggerEvent event;
+  if (!histories_[dev].Latest(event)) {
+    time = std::numeric_limits<uint64_t>::max();
     return false;
   }
-  time = std::get<1>(status_map_[dev]);
-  return std::get<0>(status_map_[dev]);
+  time = event.time_us;
+  return true;
 }
-void TriggerManger::UpdateAndPublishDevice(const TriggerDevice dev, const int bit_index, uint64_t time) {
-  if (bool status = GetBool(status_, bit_index)) {
-    status_map_[dev] = std::tuple(status, time);
-    PublishDeviceStatus(dev, time, status);
+
+bool TriggerManger::GetLatestTrigger(const TriggerDevice dev, TriggerEvent& event) const {
+  return static_cast<size_t>(dev) < k_trigger_channel_count && histories_[dev].Latest(event);
+}
+
+bool TriggerManger::GetTriggerBySeq(const TriggerDevice dev, const uint64_t seq, TriggerEvent& event) const {
+  return static_cast<size_t>(dev) < k_trigger_channel_count && histories_[dev].FindBySeq(seq, event);
+}
+
+bool TriggerManger::GetTriggerByIndex(const TriggerDevice dev, const uint64_t index, TriggerEvent& event) const {
+  return static_cast<size_t>(dev) < k_trigger_channel_count && histories_[dev].FindByIndex(index, event);
+}
+
+uint64_t TriggerManger::GetTriggerPeriod(const TriggerDevice dev) const {
+  return static_cast<size_t>(dev) < k_trigger_channel_count ? histories_[dev].Period() : 0;
+}
+
+uint64_t TriggerManger::GetLostTriggers(const TriggerDevice dev) const {
+  return static_cast<size_t>(dev) < k_trigger_channel_count ? histories_[dev].Lost() : 0;
+}
+
+bool TriggerManger::GetTriggerBefore(const TriggerDevice dev, const uint64_t time_us, TriggerEvent& event) const {
+  return static_cast<size_t>(dev) < k_trigger_channel_count && histories_[dev].FindBefore(time_us, event);
+}
+
+std::vector<TriggerEvent> TriggerManger::GetTriggersInRange(const TriggerDevice dev, const uint64_t begin_us,
+                                                            const uint64_t end_us) const {
+  std::vector<TriggerEvent> events;
+  if (static_cast<size_t>(dev) < k_trigger_channel_count) {
+    histories_[dev].FindRange(begin_us, end_us, events);
   }
+  return events;
 }
-void TriggerManger::PublishDeviceStatus(const TriggerDevice dev, const uint64_t time, const bool status) {
+
+void TriggerManger::PublishDeviceStatus(const TriggerDevice dev, const uint64_t time, const bool status) const {
   try {
     const struct DeviceStatus {
       uint64_t timestamp;
       bool status;
     } dev_data{time, status};
-    Messenger::GetInstance().PubStruct(device_map_topics[dev], &dev_data, sizeof(DeviceStatus));
+    Messenger::GetInstance().PubStruct(topics_[dev], &dev_data, sizeof(DeviceStatus));
   } catch (const std::exception& e) {
-    LOG(ERROR) << "Failed to publish " << device_map_topics[dev] << " status: " << e.what();
+    LOG(ERROR) << "Failed to publish " << topics_[dev] << " status: " << e.what();
   }
 }
-}  // namespace infinite_sense
\ No newline at end of file
+}  // namespace infinite_sense
@@ -2,15 +2,20 @@
 #include "infinite_sense.h"
 #include "ptp.h"
 #include "data.h"
+#include "clock.h"
+
+#include <array>
 
 namespace infinite_sense {
 
-UsbManager::UsbManager(std::string port, const int baud_rate) : port_(std::move(port)), started_(false) {
+UsbManager::UsbManager(std::string port, const int baud_rate, const bool low_latency)
+    : port_(std::move(port)), baud_rate_(baud_rate), low_latency_(low_latency), started_(false) {
   serial_ptr_ = std::make_unique<serial::Serial>();
   try {
     serial_ptr_->setPort(port_);
     serial_ptr_->setBaudrate(baud_rate);
-    serial::Timeout to = serial::Timeout::simpleTimeout(1000);
+    // 低延迟模式下接收线程阻塞在 waitReadable 上，超时只用于检查退出标志
+    serial::Timeout to = serial::Timeout::simpleTimeout(low_latency_ ? 100 : 1000);
     serial_ptr_->setTimeout(to);
     serial_ptr_->open();
     if (serial_ptr_->isOpen()) {
@@ -20,6 +25,13 @@ UsbManager::UsbManager(std::string port, const int baud_rate) : port_(std::move(
       LOG(ERROR) << "Failed to open serial port: " << port_;
       return;
     }
+    if (low_latency_) {
+      if (serial_ptr_->setLowLatency(true)) {
+        LOG(INFO) << "Serial port " << port_ << " low latency mode enabled.";
+      } else {
+        LOG(WARNING) << "Driver of " << port_ << " does not support ASYNC_LOW_LATENCY, using batched reads only.";
+      }
+    }
     ptp_ = std::make_unique<Ptp>();
     ptp_->SetUsbPtr(serial_ptr_);
   } catch (const serial::IOException& e) {
@@ -63,7 +75,11 @@ void UsbManager::Stop() {
   LOG(INFO) << "USB manager stopped";
 }
 
-void UsbManager::Receive() const {
+void UsbManager::Receive() {
+  if (low_latency_) {
+    ReceiveLowLatency();
+    return;
+  }
   while (started_) {
     try {
       if (!serial_ptr_ || !serial_ptr_->isOpen()) {
@@ -75,16 +91,8 @@ void UsbManager::Receive() const {
           LOG(WARNING) << "Received empty string.";
           continue;
         }
-        auto json_data = nlohmann::json::parse(serial_recv, nullptr, false);
-        if (json_data.is_discarded()) {
-          LOG(WARNING) << "Received malformed JSON: " << serial_recv;
-          continue;
-        }
-        ptp_->ReceivePtpData(json_data);
-        ProcessTriggerData(json_data);
-        ProcessIMUData(json_data);
-        ProcessGPSData(json_data);
-        ProcessLOGData(json_data);
+        Record(serial_recv.data(), serial_recv.size());
+        HandleLine(serial_recv.data(), serial_recv.size());
       }
       std::this_thread::sleep_for(std::chrono::milliseconds(1));
     } catch (const std::exception& e) {
@@ -93,11 +101,114 @@ void UsbManager::Receive() const {
   }
 }
 
+void UsbManager::ReceiveLowLatency() {
+  constexpr size_t k_read_size = 4096;
+  constexpr size_t k_max_line_size = 65536;
+  std::array<uint8_t, k_read_size> buffer{};
+  std::string pending;
+  auto last_report = std::chrono::steady_clock::now();
+
+  while (started_) {
+    try {
+      if (!serial_ptr_ || !serial_ptr_->isOpen()) {
+        break;
+      }
+      // 阻塞等待数据到达，不再轮询 sleep；readline 逐字节读取的系统调用也改为整批读取
+      if (!serial_ptr_->waitReadable()) {
+        continue;
+      }
+      const auto wake_time = std::chrono::steady_clock::now();
+      const size_t available = serial_ptr_->available();
+      if (available == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        continue;
+      }
+      const size_t size = serial_ptr_->read(buffer.data(), std::min(available, k_read_size));
+      Record(buffer.data(), size);
+      pending.append(reinterpret_cast<const char*>(buffer.data()), size);
+
+      size_t begin = 0;
+      for (size_t end = pending.find('\n'); end != std::string::npos; end = pending.find('\n', begin)) {
+        if (end > begin) {
+          HandleLine(pending.data() + begin, end - begin);
+        }
+        begin = end + 1;
+      }
+      pending.erase(0, begin);
+      if (pending.size() > k_max_line_size) {
+        LOG(WARNING) << "Serial line exceeds " << k_max_line_size << " bytes, dropped.";
+        pending.clear();
+      }
+
+      // 同一批到达的 size 个字节中，第 i 个字节已在驱动中等待了 (size - 1 - i) 个字节时间
+      const auto handle_ns =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wake_time).count();
+      stat_bytes_ += size;
+      stat_reads_ += 1;
+      stat_batch_byte_times_ += size * (size - 1) / 2;
+      stat_handle_ns_ += handle_ns;
+      if (size > stat_max_chunk_) {
+        stat_max_chunk_ = size;
+      }
+      if (wake_time - last_report > std::chrono::seconds(10)) {
+        last_report = wake_time;
+        const SerialLatencyStats stats = GetLatencyStats();
+        LOG(INFO) << "Serial " << port_ << " latency: " << stats.estimated_batch_latency_us
+                  << " us/byte batching (estimated), "
+                  << stats.mean_handle_latency_us << " us/byte handling, "
+                  << static_cast<double>(stats.bytes) / static_cast<double>(stats.reads) << " bytes/read, max "
+                  << stats.max_chunk;
+      }
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Receive thread exception: " << e.what();
+    }
+  }
+}
+
+void UsbManager::Record(const void* data, const size_t size) const {
+  if (recorder_ && size > 0) {
+    recorder_->Write(RawSource::USB, HostClock::NowNs(), data, size);
+  }
+}
+
+void UsbManager::HandleLine(const char* data, const size_t size) const {
+  try {
+    auto json_data = nlohmann::json::parse(data, data + size, nullptr, false);
+    if (json_data.is_discarded()) {
+      LOG(WARNING) << "Received malformed JSON: " << std::string(data, size);
+      return;
+    }
+    ptp_->ReceivePtpData(json_data);
+    ProcessDeviceMessage(json_data);
+  } catch (const nlohmann::json::exception& e) {
+    LOG(ERROR) << "Exception during JSON handling: " << e.what();
+  }
+}
+
+SerialLatencyStats UsbManager::GetLatencyStats() const {
+  SerialLatencyStats stats;
+  stats.bytes = stat_bytes_;
+  stats.reads = stat_reads_;
+  stats.max_chunk = stat_max_chunk_;
+  stats.byte_time_us = baud_rate_ > 0 ? 10e6 / baud_rate_ : 0;
+  if (stats.bytes > 0) {
+    stats.estimated_batch_latency_us =
+        static_cast<double>(stat_batch_byte_times_) * stats.byte_time_us / static_cast<double>(stats.bytes);
+    stats.mean_handle_latency_us = static_cast<double>(stat_handle_ns_) * 1e-3 / static_cast<double>(stats.bytes);
+  }
+  return stats;
+}
+
 void UsbManager::TimeStampSynchronization() const {
   while (started_) {
     try {
       ptp_->SendPtpData();
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      ptp_->PublishSyncQuality();
+      // 按 Ptp 给出的自适应间隔等待，分片睡眠以便及时响应 Stop
+      const auto next = std::chrono::steady_clock::now() + ptp_->NextSyncInterval();
+      while (started_ && std::chrono::steady_clock::now() < next) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
     } catch (const std::exception& e) {
       LOG(ERROR) << "Timestamp sync exception: " << e.what();
     }
@@ -0,0 +1,73 @@
+// FrameDropMonitor 的纯逻辑测试：按时间顺序回放触发消息与相机帧，检查漏触发的计数
+//
+// 触发周期 50 ms，曝光 5 ms；延迟在 8 ms 与 53 ms 之间交替，跨过一个触发周期，在途帧数在 0 与 1 之间反复变化。
+// 发布周期为 0，每帧都是一个统计周期。每个场景使用独立的触发通道，互不影响。
+#include "drop_monitor.h"
+#include "latency_model.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace {
+using namespace infinite_sense;
+
+constexpr uint64_t k_period_us = 50000;
+constexpr uint64_t k_start_us = 1000000;
+constexpr double k_exposure_us = 5000;
+constexpr uint64_t k_frame_base = 1000;
+constexpr uint64_t k_triggers = 300;
+
+int failures = 0;
+
+#define EXPECT(cond)                                                              \
+  do {                                                                            \
+    if (!(cond)) {                                                                \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": EXPECT(" #cond ") failed\n"; \
+      ++failures;                                                                 \
+    }                                                                             \
+  } while (0)
+
+uint64_t TriggerTime(const uint64_t k) { return k_start_us + k * k_period_us; }
+
+uint64_t Latency(const uint64_t k) { return k % 2 == 0 ? 8000 : 53000; }
+
+// 回放 k_triggers 次触发，相机没有响应 missed 中的触发，帧计数只在响应时递增；返回统计的漏触发数
+uint64_t Replay(const TriggerDevice dev, const std::vector<uint64_t> &missed) {
+  TriggerManger &manager = TriggerManger::GetInstance();
+  FrameDropMonitor drops(dev, "test", 30, 0);
+  CaptureLatencyModel model(dev, "test");
+  uint64_t frame_num = k_frame_base;
+  uint64_t next = 0;
+  for (uint64_t k = 0; k < k_triggers; ++k) {
+    if (std::find(missed.begin(), missed.end(), k) != missed.end()) {
+      continue;
+    }
+    const uint64_t arrival = TriggerTime(k) + Latency(k);
+    for (; next < k_triggers && TriggerTime(next) <= arrival; ++next) {
+      manager.SetLastTriggerStatus(TriggerTime(next), TriggerMask().set(dev), (TriggerTime(next) - k_start_us) / 2000);
+    }
+    drops.Update(frame_num++, nullptr, model.Window(arrival, k_exposure_us));
+  }
+  drops.Poll();
+  return drops.GetStats().missed_triggers;
+}
+
+// 延迟抖动使在途帧数反复变化，没有漏触发
+void TestJitter() { EXPECT(Replay(CAM_7, {}) == 0); }
+
+// 相机漏掉第 100、200 次触发
+void TestMissedTriggers() { EXPECT(Replay(CAM_8, {100, 200}) == 2); }
+}  // namespace
+
+int main() {
+  TestJitter();
+  TestMissedTriggers();
+  if (failures > 0) {
+    std::cerr << failures << " check(s) failed\n";
+    return 1;
+  }
+  std::cout << "all checks passed\n";
+  return 0;
+}
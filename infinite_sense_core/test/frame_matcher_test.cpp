@@ -0,0 +1,211 @@
+// FrameTriggerMatcher 与 TriggerManger 的纯逻辑测试：按时间顺序回放触发消息与相机帧，检查每帧关联的触发
+//
+// 触发周期 50 ms，曝光 5 ms，触发到取图的延迟 20~23 ms；同步板 "c" 字段按采集节拍递增（每次触发加 25）。
+// 每个场景使用独立的触发通道，互不影响。
+#include "frame_matcher.h"
+#include "latency_model.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+using namespace infinite_sense;
+
+constexpr uint64_t k_period_us = 50000;
+constexpr uint64_t k_start_us = 1000000;
+constexpr double k_exposure_us = 5000;
+constexpr uint64_t k_frame_base = 1000;  // 相机帧计数与触发序号的初始差值
+constexpr uint64_t k_triggers = 300;
+
+int failures = 0;
+
+#define EXPECT(cond)                                                              \
+  do {                                                                            \
+    if (!(cond)) {                                                                \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": EXPECT(" #cond ") failed\n"; \
+      ++failures;                                                                 \
+    }                                                                             \
+  } while (0)
+
+uint64_t TriggerTime(const uint64_t k) { return k_start_us + k * k_period_us; }
+
+uint64_t Latency(const uint64_t k) { return 20000 + k * 7919 % 3000; }
+
+struct Frame {
+  uint64_t arrival_us;
+  uint64_t frame_num;
+  uint64_t trigger_us;  // 该帧真实的触发时间
+};
+
+struct Result {
+  FrameMatchStats stats;
+  std::vector<uint64_t> wrong;  // 关联错误的帧计数
+};
+
+// 按时间顺序回放：同一时刻先送达触发消息；帧的处理与 MvCam 一致，只用锁定后的帧更新延迟模型
+Result Replay(const TriggerDevice dev, const std::vector<uint64_t>& triggers, std::vector<Frame> frames,
+              const double prior_min_us = 0, const double prior_max_us = 0) {
+  std::sort(frames.begin(), frames.end(), [](const Frame& a, const Frame& b) { return a.arrival_us < b.arrival_us; });
+  TriggerManger& manager = TriggerManger::GetInstance();
+  FrameTriggerMatcher matcher(dev, "test");
+  CaptureLatencyModel model(dev, "test");
+  model.SetPriorRange(prior_min_us, prior_max_us);
+  Result result;
+  size_t next = 0;
+  for (const Frame& frame : frames) {
+    for (; next < triggers.size() && triggers[next] <= frame.arrival_us; ++next) {
+      manager.SetLastTriggerStatus(triggers[next], TriggerMask().set(dev), (triggers[next] - k_start_us) / 2000);
+    }
+    const TriggerWindow window = model.Window(frame.arrival_us, k_exposure_us);
+    TriggerEvent trigger;
+    const bool matched = matcher.Match(frame.frame_num, window, trigger);
+    if (!matched || trigger.time_us != frame.trigger_us) {
+      result.wrong.push_back(frame.frame_num);
+    }
+    if (matched && matcher.GetStats().locked) {
+      model.Record(frame.arrival_us, trigger.time_us, k_exposure_us);
+    }
+  }
+  result.stats = matcher.GetStats();
+  return result;
+}
+
+std::vector<uint64_t> AllTriggers() {
+  std::vector<uint64_t> triggers;
+  for (uint64_t k = 0; k < k_triggers; ++k) {
+    triggers.push_back(TriggerTime(k));
+  }
+  return triggers;
+}
+
+// 取图线程在第 200 帧处停顿 4 个触发周期，积压的帧随后被集中取出：全程保持锁定，每帧关联正确
+void TestDelayedFrames() {
+  std::vector<Frame> frames;
+  for (uint64_t k = 0; k < k_triggers; ++k) {
+    uint64_t arrival = TriggerTime(k) + Latency(k);
+    if (k >= 200 && k < 204) {
+      arrival = TriggerTime(204) + Latency(204) - (204 - k) * 300;
+    }
+    frames.push_back({arrival, k + k_frame_base, TriggerTime(k)});
+  }
+  const Result result = Replay(CAM_1, AllTriggers(), frames);
+  EXPECT(result.wrong.empty());
+  EXPECT(result.stats.locks == 1);
+  EXPECT(result.stats.mismatches == 0);
+  EXPECT(result.stats.locked);
+}
+
+// 相机漏掉第 200 次触发，之后 触发序号 - 帧计数 变大 1：迟到若干帧后重新对齐，只有判定前的帧关联错误
+void TestMissedTrigger() {
+  std::vector<Frame> frames;
+  for (uint64_t k = 0; k < k_triggers; ++k) {
+    if (k == 200) {
+      continue;
+    }
+    const uint64_t frame_num = (k < 200 ? k : k - 1) + k_frame_base;
+    frames.push_back({TriggerTime(k) + Latency(k), frame_num, TriggerTime(k)});
+  }
+  const Result result = Replay(CAM_2, AllTriggers(), frames);
+  EXPECT(result.wrong.size() <= 2);
+  for (const uint64_t frame_num : result.wrong) {
+    EXPECT(frame_num >= 200 + k_frame_base && frame_num < 203 + k_frame_base);
+  }
+  EXPECT(result.stats.mismatches == 1);
+  EXPECT(result.stats.locks == 2);
+  EXPECT(result.stats.locked);
+  EXPECT(result.stats.offset == -static_cast<int64_t>(k_frame_base) + 1);
+}
+
+// 第 200 次触发的消息丢失：由触发间隔判定丢包并重新对齐，只有丢失触发对应的帧无法正确关联
+void TestLostTriggerMessage() {
+  std::vector<uint64_t> triggers = AllTriggers();
+  triggers.erase(triggers.begin() + 200);
+  std::vector<Frame> frames;
+  for (uint64_t k = 0; k < k_triggers; ++k) {
+    frames.push_back({TriggerTime(k) + Latency(k), k + k_frame_base, TriggerTime(k)});
+  }
+  const Result result = Replay(CAM_3, triggers, frames);
+  EXPECT(TriggerManger::GetInstance().GetLostTriggers(CAM_3) == 1);
+  EXPECT(TriggerManger::GetInstance().GetTriggerPeriod(CAM_3) == k_period_us);
+  EXPECT(result.wrong.size() == 1);
+  EXPECT(result.wrong.size() == 1 && result.wrong.front() == 200 + k_frame_base);
+  EXPECT(result.stats.mismatches == 1);
+  EXPECT(result.stats.locked);
+  EXPECT(result.stats.offset == -static_cast<int64_t>(k_frame_base) - 1);
+}
+
+// 延迟范围宽于一个触发周期时窗口内有多个触发，关联不确定，不能锁定
+void TestAmbiguousWindow() {
+  std::vector<Frame> frames;
+  for (uint64_t k = 0; k < k_triggers; ++k) {
+    frames.push_back({TriggerTime(k) + Latency(k), k + k_frame_base, TriggerTime(k)});
+  }
+  const Result result = Replay(CAM_4, AllTriggers(), frames, k_exposure_us, 2 * k_period_us);
+  EXPECT(result.stats.locks == 0);
+  EXPECT(!result.stats.locked);
+  EXPECT(result.stats.ambiguous + 1 >= result.stats.frames);
+}
+
+// 传输时间超过一个触发周期（70~73 ms）：默认范围会对齐到更新的触发，按链路给出延迟范围后关联正确
+void TestSlowLink() {
+  std::vector<Frame> frames;
+  for (uint64_t k = 0; k < k_triggers; ++k) {
+    frames.push_back({TriggerTime(k) + k_period_us + Latency(k), k + k_frame_base, TriggerTime(k)});
+  }
+  const Result result = Replay(CAM_5, AllTriggers(), frames, 60000, 90000);
+  EXPECT(result.wrong.empty());
+  EXPECT(result.stats.locks == 1);
+  EXPECT(result.stats.offset == -static_cast<int64_t>(k_frame_base));
+}
+
+// 第 200 帧比延迟下限快得多（8 ms）：锁定后的上限取历史最小延迟放宽半个周期，偶尔偏快的帧不破坏正确的锁定
+void TestFastFrame() {
+  std::vector<Frame> frames;
+  for (uint64_t k = 0; k < k_triggers; ++k) {
+    const uint64_t latency = k == 200 ? 8000 : Latency(k);
+    frames.push_back({TriggerTime(k) + latency, k + k_frame_base, TriggerTime(k)});
+  }
+  const Result result = Replay(CAM_6, AllTriggers(), frames);
+  EXPECT(result.wrong.empty());
+  EXPECT(result.stats.locks == 1);
+  EXPECT(result.stats.mismatches == 0);
+  EXPECT(result.stats.locked);
+}
+
+// 同步板把触发周期从 50 ms 改为 100 ms：重新估计周期，不计为丢失，锁定不受影响
+void TestRateChange() {
+  std::vector<uint64_t> triggers;
+  std::vector<Frame> frames;
+  uint64_t time = k_start_us;
+  for (uint64_t k = 0; k < k_triggers; ++k) {
+    triggers.push_back(time);
+    frames.push_back({time + Latency(k), k + k_frame_base, time});
+    time += k < 150 ? k_period_us : 2 * k_period_us;
+  }
+  const Result result = Replay(CAM_7, triggers, frames);
+  EXPECT(TriggerManger::GetInstance().GetLostTriggers(CAM_7) == 0);
+  EXPECT(TriggerManger::GetInstance().GetTriggerPeriod(CAM_7) == 2 * k_period_us);
+  EXPECT(result.wrong.empty());
+  EXPECT(result.stats.mismatches == 0);
+  EXPECT(result.stats.locked);
+}
+}  // namespace
+
+int main() {
+  TestDelayedFrames();
+  TestMissedTrigger();
+  TestLostTriggerMessage();
+  TestAmbiguousWindow();
+  TestSlowLink();
+  TestFastFrame();
+  TestRateChange();
+  if (failures > 0) {
+    std::cerr << failures << " check(s) failed\n";
+    return 1;
+  }
+  std::cout << "all checks passed\n";
+  return 0;
+}
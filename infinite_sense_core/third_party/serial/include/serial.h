@@ -614,6 +614,21 @@ public:
   void
   setDTR (bool level = true);
 
+  /*!
+   * Requests low latency mode from the tty driver (ASYNC_LOW_LATENCY).
+   *
+   * On FTDI adapters this lowers the driver latency timer to 1 ms, other
+   * drivers may push received bytes to the tty layer immediately instead of
+   * batching them. Drivers without TIOCSSERIAL support (e.g. most CDC-ACM
+   * devices) already deliver each USB packet immediately.
+   *
+   * \return Returns true if the driver accepted the request.
+   *
+   * \throw PortNotOpenedException
+   */
+  bool
+  setLowLatency (bool enable = true);
+
   /*!
    * Blocks until CTS, DSR, RI, CD changes or something interrupts it.
    *
@@ -119,6 +119,9 @@ public:
   void
   setDTR (bool level);
 
+  bool
+  setLowLatency (bool enable);
+
   bool
   waitForChange ();
 
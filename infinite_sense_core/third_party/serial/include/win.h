@@ -108,6 +108,9 @@ public:
   void
   setDTR (bool level);
 
+  bool
+  setLowLatency (bool enable);
+
   bool
   waitForChange ();
 
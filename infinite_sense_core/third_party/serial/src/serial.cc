@@ -406,6 +406,11 @@ void Serial::setDTR (bool level)
   pimpl_->setDTR (level);
 }
 
+bool Serial::setLowLatency (bool enable)
+{
+  return pimpl_->setLowLatency (enable);
+}
+
 bool Serial::waitForChange()
 {
   return pimpl_->waitForChange();
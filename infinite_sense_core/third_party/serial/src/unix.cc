@@ -918,6 +918,31 @@ Serial::SerialImpl::setDTR (bool level)
   }
 }
 
+bool
+Serial::SerialImpl::setLowLatency (bool enable)
+{
+  if (is_open_ == false) {
+    throw PortNotOpenedException ("Serial::setLowLatency");
+  }
+
+#if defined(__linux__) && defined(TIOCSSERIAL) && defined(ASYNC_LOW_LATENCY)
+  struct serial_struct ser;
+
+  if (-1 == ioctl (fd_, TIOCGSERIAL, &ser)) {
+    return false;
+  }
+  if (enable) {
+    ser.flags |= ASYNC_LOW_LATENCY;
+  } else {
+    ser.flags &= ~ASYNC_LOW_LATENCY;
+  }
+  return -1 != ioctl (fd_, TIOCSSERIAL, &ser);
+#else
+  (void) enable;
+  return false;
+#endif
+}
+
 bool
 Serial::SerialImpl::waitForChange ()
 {
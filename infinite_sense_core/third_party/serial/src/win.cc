@@ -531,6 +531,16 @@ Serial::SerialImpl::setDTR (bool level)
   }
 }
 
+bool
+Serial::SerialImpl::setLowLatency (bool enable)
+{
+  if (is_open_ == false) {
+    throw PortNotOpenedException ("Serial::setLowLatency");
+  }
+  (void) enable;
+  return false;
+}
+
 bool
 Serial::SerialImpl::waitForChange ()
 {
@@ -0,0 +1,130 @@
+// Bayer 去马赛克基准：比较各指令集实现的耗时，并校验 SIMD 输出与标量实现逐字节一致
+//
+// 用法: demosaic_bench [-n 轮数] [-s 宽x高]
+//   默认 2048x1536（与 MvCam 转换缓冲区上限一致），8 位、12 位与 12 位打包三种输入，RGGB 与 GBRG 两种相位。
+//   相机 SDK 转换（MV_CC_ConvertPixelType）的耗时由 MvCam 每 5000 帧输出，可与本工具的结果对照。
+#include "demosaic.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+using namespace infinite_sense;
+
+struct Input {
+  std::string name;
+  int bit_depth;
+  bool packed;
+};
+
+// 带边缘与噪声的合成图像，避免整幅均匀导致边缘感知分支失真
+std::vector<uint8_t> MakeRaw(const int width, const int height, const Input& input, size_t& stride) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> noise(0, 63);
+  const int max_value = (1 << input.bit_depth) - 1;
+  stride = input.bit_depth == 8 ? width : (input.packed ? width / 2 * 3 : width * 2);
+  std::vector<uint8_t> raw(stride * height);
+  for (int y = 0; y < height; ++y) {
+    uint8_t* row = raw.data() + y * stride;
+    for (int x = 0; x < width; ++x) {
+      const int base = ((x / 64 + y / 64) % 2 == 0 ? max_value / 4 : max_value * 3 / 4);
+      const int value = std::min(max_value, base + noise(rng) * (max_value + 1) / 256);
+      if (input.bit_depth == 8) {
+        row[x] = static_cast<uint8_t>(value);
+      } else if (input.packed) {
+        // GigE Vision packed：第 0、2 字节为高 8 位，第 1 字节两个半字节为低位
+        const int shift = input.bit_depth - 8;
+        uint8_t* triple = row + 3 * (x / 2);
+        triple[x % 2 == 0 ? 0 : 2] = static_cast<uint8_t>(value >> shift);
+        triple[1] |= static_cast<uint8_t>((value & ((1 << shift) - 1)) << (x % 2 == 0 ? 0 : 4));
+      } else {
+        const auto v = static_cast<uint16_t>(value);
+        std::memcpy(row + 2 * x, &v, sizeof(v));
+      }
+    }
+  }
+  return raw;
+}
+
+const char* LevelName(const SimdLevel level) {
+  switch (level) {
+    case SimdLevel::AVX2:
+      return "avx2";
+    case SimdLevel::SSE4:
+      return "sse4";
+    default:
+      return "scalar";
+  }
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  int rounds = 50;
+  int width = 2048, height = 1536;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-n" && i + 1 < argc) {
+      rounds = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "-s" && i + 1 < argc && std::sscanf(argv[++i], "%dx%d", &width, &height) == 2) {
+      width = std::max(2, width & ~1);
+      height = std::max(2, height);
+    } else {
+      std::cerr << "Usage: " << argv[0] << " [-n rounds] [-s WIDTHxHEIGHT]\n";
+      return 1;
+    }
+  }
+
+  const std::vector<Input> inputs = {{"bayer8", 8, false}, {"bayer12", 12, false}, {"bayer12p", 12, true}};
+  const std::vector<std::pair<std::string, DemosaicMethod>> methods = {{"bilinear", DemosaicMethod::BILINEAR},
+                                                                       {"edge", DemosaicMethod::EDGE_AWARE}};
+  std::vector<SimdLevel> levels = {SimdLevel::SCALAR};
+  if (BestSimdLevel() >= SimdLevel::SSE4) {
+    levels.push_back(SimdLevel::SSE4);
+  }
+  if (BestSimdLevel() >= SimdLevel::AVX2) {
+    levels.push_back(SimdLevel::AVX2);
+  }
+
+  std::cout << width << "x" << height << ", " << rounds << " rounds, best " << LevelName(BestSimdLevel()) << "\n";
+  std::cout << std::left << std::setw(10) << "input" << std::setw(10) << "method" << std::setw(8) << "phase"
+            << std::setw(8) << "isa" << std::right << std::setw(10) << "ms" << std::setw(10) << "MP/s"
+            << std::setw(8) << "match" << "\n";
+
+  const size_t bgr_stride = static_cast<size_t>(width) * 3;
+  std::vector<uint8_t> reference(bgr_stride * height), bgr(bgr_stride * height);
+  bool all_match = true;
+  for (const auto& input : inputs) {
+    size_t stride = 0;
+    const std::vector<uint8_t> raw = MakeRaw(width, height, input, stride);
+    for (const BayerPattern pattern : {BayerPattern::RGGB, BayerPattern::GBRG}) {
+      const BayerImage image{raw.data(), width, height, stride, pattern, input.bit_depth, input.packed};
+      for (const auto& [method_name, method] : methods) {
+        DemosaicBayer(image, reference.data(), bgr_stride, method, SimdLevel::SCALAR);
+        for (const SimdLevel level : levels) {
+          std::fill(bgr.begin(), bgr.end(), 0);
+          const auto begin = std::chrono::steady_clock::now();
+          for (int r = 0; r < rounds; ++r) {
+            DemosaicBayer(image, bgr.data(), bgr_stride, method, level);
+          }
+          const double ms =
+              std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count() / rounds;
+          const bool match = bgr == reference;
+          all_match = all_match && match;
+          std::cout << std::left << std::setw(10) << input.name << std::setw(10) << method_name << std::setw(8)
+                    << (pattern == BayerPattern::RGGB ? "rggb" : "gbrg") << std::setw(8) << LevelName(level)
+                    << std::right << std::fixed << std::setprecision(2) << std::setw(10) << ms << std::setw(10)
+                    << static_cast<double>(width) * height / (ms * 1000) << std::setw(8) << (match ? "yes" : "NO")
+                    << "\n";
+        }
+      }
+    }
+  }
+  return all_match ? 0 : 2;
+}
@@ -0,0 +1,25 @@
+// libFuzzer 入口：覆盖接收线程中 json 解析 -> Ptp -> ProcessDeviceMessage 的完整路径
+//
+// 构建: cmake -DCMAKE_CXX_COMPILER=clang++ -DINFINITE_SENSE_BUILD_FUZZERS=ON ..
+// 运行: ./fuzz_device_message -max_len=4096 ../infinite_sense_core/tools/corpus
+#include "infinite_sense.h"
+#include "ptp.h"
+#include "data.h"
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, const size_t size) {
+  static infinite_sense::Ptp ptp;
+  try {
+    const auto json_data = nlohmann::json::parse(data, data + size, nullptr, false);
+    if (json_data.is_discarded()) {
+      return 0;
+    }
+    ptp.ReceivePtpData(json_data);
+    infinite_sense::ProcessDeviceMessage(json_data);
+  } catch (const nlohmann::json::exception &) {
+    // 与接收线程一致：字段缺失或类型错误只会抛出异常，不允许崩溃
+  }
+  return 0;
+}
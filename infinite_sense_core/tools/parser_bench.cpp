@@ -0,0 +1,154 @@
+// 设备消息解析吞吐基准：按消息类型统计 json 解析 + 分发的 lines/s 与 ns/line
+//
+// 用法: parser_bench [-n 轮数] [文件或目录 ...]
+//   不带文件参数时只使用内置的合成消息；文件按行读取，每行一条设备消息（与串口上报格式一致），
+//   目录则读取其中所有文件（例如 tools/corpus）。
+#include "infinite_sense.h"
+#include "data.h"
+#include "ptp.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+using namespace infinite_sense;
+
+struct BenchStats {
+  size_t lines{0};
+  size_t bytes{0};
+  size_t errors{0};
+  double total_ns{0};
+};
+
+std::vector<std::string> SyntheticLines() {
+  std::vector<std::string> lines;
+  for (int i = 0; i < 1000; ++i) {
+    const std::string t = std::to_string(1745767254869878ULL + i * 1000ULL);
+    lines.push_back(R"({"f":"imu","t":)" + t + R"(,"c":)" + std::to_string(920480 + i) +
+                    R"(,"d":[0.416606,-0.181966,9.993754,0.003141,0.001038,0.000016,28.50241],)"
+                    R"("q":[0.999765,-0.009251,-0.021048,-0.013569]})");
+    lines.push_back(R"({"f":"t","s":)" + std::to_string(1 << (i % 8)) + R"(,"t":)" + t + R"(,"c":)" +
+                    std::to_string(893482 + i) + "}");
+    lines.push_back(R"({"f":"GNGGA","g":false,"t":)" + t +
+                    R"(,"d":"$GNGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r","pps":)" + t +
+                    "}");
+    lines.push_back(R"({"f":"a","a":)" + t + R"(,"b":)" + t + "}");
+    lines.push_back(R"({"f":"b","a":)" + t + "}");
+    // 串口丢字节时常见的截断行
+    const std::string &imu = lines[lines.size() - 5];
+    lines.push_back(imu.substr(0, 1 + i % (imu.size() - 1)));
+  }
+  return lines;
+}
+
+void LoadFile(const std::filesystem::path &path, std::vector<std::string> &lines) {
+  std::ifstream in(path);
+  if (!in) {
+    LOG(WARNING) << "Cannot open " << path;
+    return;
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    if (!line.empty()) {
+      lines.push_back(line);
+    }
+  }
+}
+
+std::string MessageType(const std::string &line) {
+  const auto json_data = nlohmann::json::parse(line, nullptr, false);
+  if (json_data.is_discarded()) {
+    return "malformed";
+  }
+  if (!json_data.is_object() || !json_data.contains("f") || !json_data["f"].is_string()) {
+    return "unknown";
+  }
+  // 时间同步请求与回复成对出现，放在同一组内保持先后顺序，Ptp 才会完成整次交换
+  const std::string &type = json_data["f"].get_ref<const std::string &>();
+  return type == "a" || type == "b" ? "ptp" : type;
+}
+
+// 与 NetManager/UsbManager 接收线程相同的解析与分发路径：时间同步交换交给 Ptp，其余消息统一分发。
+// Ptp 未设置链路，回复报文不发送，但最小往返时延过滤、时钟估计与时间换算照常执行
+bool Ingest(Ptp &ptp, const std::string &line) {
+  try {
+    const auto json_data = nlohmann::json::parse(line.data(), line.data() + line.size(), nullptr, false);
+    if (json_data.is_discarded()) {
+      return false;
+    }
+    ptp.ReceivePtpData(json_data);
+    ProcessDeviceMessage(json_data);
+    return true;
+  } catch (const std::exception &) {
+    return false;
+  }
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int rounds = 20;
+  std::vector<std::string> lines;
+  bool has_input = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-n" && i + 1 < argc) {
+      rounds = std::max(1, std::atoi(argv[++i]));
+      continue;
+    }
+    has_input = true;
+    if (std::filesystem::is_directory(arg)) {
+      for (const auto &entry : std::filesystem::directory_iterator(arg)) {
+        LoadFile(entry.path(), lines);
+      }
+    } else {
+      LoadFile(arg, lines);
+    }
+  }
+  if (!has_input) {
+    lines = SyntheticLines();
+  }
+
+  std::map<std::string, std::vector<const std::string *>> buckets;
+  for (const auto &line : lines) {
+    buckets[MessageType(line)].push_back(&line);
+  }
+
+  Ptp ptp;
+  std::map<std::string, BenchStats> results;
+  for (const auto &[type, bucket] : buckets) {
+    BenchStats &stats = results[type];
+    for (int r = 0; r < rounds; ++r) {
+      const auto start = std::chrono::steady_clock::now();
+      for (const auto *line : bucket) {
+        if (!Ingest(ptp, *line)) {
+          ++stats.errors;
+        }
+        stats.bytes += line->size();
+      }
+      stats.total_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      stats.lines += bucket.size();
+    }
+  }
+
+  std::cout << std::left << std::setw(12) << "type" << std::right << std::setw(12) << "lines" << std::setw(14)
+            << "lines/s" << std::setw(12) << "ns/line" << std::setw(12) << "MB/s" << std::setw(10) << "errors"
+            << "\n";
+  for (const auto &[type, stats] : results) {
+    if (stats.lines == 0 || stats.total_ns <= 0) {
+      continue;
+    }
+    const double seconds = stats.total_ns * 1e-9;
+    std::cout << std::left << std::setw(12) << type << std::right << std::setw(12) << stats.lines << std::setw(14)
+              << std::fixed << std::setprecision(0) << stats.lines / seconds << std::setw(12) << std::setprecision(1)
+              << stats.total_ns / stats.lines << std::setw(12) << std::setprecision(2)
+              << stats.bytes / seconds / 1e6 << std::setw(10) << stats.errors / rounds << "\n";
+  }
+  return 0;
+}
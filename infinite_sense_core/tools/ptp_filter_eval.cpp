@@ -0,0 +1,256 @@
+// PTP 交换日志离线评估：用同一份实测交换记录比较不同的偏差过滤/估计方案
+//
+// 用法: ptp_filter_eval [-e 收敛门限us] exchange.bin
+//   exchange.bin 由 Synchronizer::SetPtpLogPath 生成。
+//
+// 记录中的偏差是同步板被校正后的锯齿状偏差，先加回累计校正量还原为同步板自由运行时的偏差。
+// 参考值为非因果估计：以每个交换为中心取 64 次交换，只用其中延迟最低的 25% 做线性拟合。
+// 各候选方案只使用当前及之前的交换（与在线运行一致），统计相对参考值的误差与收敛时间。
+#include "clock_estimator.h"
+#include "recorder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+using namespace infinite_sense;
+
+constexpr size_t k_reference_window = 64;
+constexpr double k_reference_fraction = 0.25;
+
+struct Exchange {
+  uint64_t host_us;    // t1 与 t4 的中点
+  int64_t delay_us;    // 单程延迟
+  double free_offset;  // 自由运行偏差
+  bool accepted;       // 在线运行时是否被接受
+};
+
+struct Result {
+  std::string name;
+  double rms_us{0};
+  double p95_us{0};
+  double max_us{0};
+  double converge_s{-1};
+  size_t estimates{0};
+  double accept_rate{0};
+};
+
+bool Load(const std::string& path, std::vector<Exchange>& exchanges) {
+  std::ifstream in(path, std::ios::binary);
+  char magic[sizeof(k_ptp_log_magic)];
+  if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, k_ptp_log_magic, sizeof(magic)) != 0) {
+    std::cerr << "Not a PTP exchange log: " << path << "\n";
+    return false;
+  }
+  PtpExchangeRecord record{};
+  double correction = 0;
+  while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+    const auto t1 = static_cast<int64_t>(record.t1_us), t2 = static_cast<int64_t>(record.t2_us);
+    const auto t3 = static_cast<int64_t>(record.t3_us), t4 = static_cast<int64_t>(record.t4_us);
+    Exchange exchange{};
+    exchange.host_us = record.t1_us + (record.t4_us - record.t1_us) / 2;
+    exchange.delay_us = (t4 - t3 + t2 - t1) / 2;
+    exchange.free_offset = static_cast<double>(t2 - t1 - t4 + t3) / 2 + correction;
+    exchange.accepted = record.accepted != 0;
+    exchanges.push_back(exchange);
+    correction += static_cast<double>(record.correction_us);
+  }
+  return true;
+}
+
+std::vector<double> Reference(const std::vector<Exchange>& exchanges) {
+  std::vector<double> reference(exchanges.size());
+  std::vector<const Exchange*> window;
+  for (size_t i = 0; i < exchanges.size(); ++i) {
+    const size_t last_begin = exchanges.size() > k_reference_window ? exchanges.size() - k_reference_window : 0;
+    const size_t begin = std::min(i > k_reference_window / 2 ? i - k_reference_window / 2 : 0, last_begin);
+    const size_t end = std::min(exchanges.size(), begin + k_reference_window);
+    window.clear();
+    for (size_t j = begin; j < end; ++j) {
+      window.push_back(&exchanges[j]);
+    }
+    std::sort(window.begin(), window.end(),
+              [](const Exchange* a, const Exchange* b) { return a->delay_us < b->delay_us; });
+    const auto kept = static_cast<size_t>(static_cast<double>(window.size()) * k_reference_fraction);
+    window.resize(std::min(window.size(), std::max<size_t>(2, kept)));
+
+    double mean_x = 0, mean_y = 0;
+    for (const auto* e : window) {
+      mean_x += static_cast<double>(static_cast<int64_t>(e->host_us - exchanges[i].host_us));
+      mean_y += e->free_offset;
+    }
+    mean_x /= static_cast<double>(window.size());
+    mean_y /= static_cast<double>(window.size());
+    double sxx = 0, sxy = 0;
+    for (const auto* e : window) {
+      const double dx = static_cast<double>(static_cast<int64_t>(e->host_us - exchanges[i].host_us)) - mean_x;
+      sxx += dx * dx;
+      sxy += dx * (e->free_offset - mean_y);
+    }
+    const double slope = sxx > 0 ? sxy / sxx : 0;
+    reference[i] = mean_y - slope * mean_x;
+  }
+  return reference;
+}
+
+// 候选方案：依次接收每个交换，返回该时刻的偏差估计与该交换是否被接受；返回 false 表示尚无估计
+using Candidate = std::function<bool(const Exchange&, double&, bool&)>;
+
+Candidate Raw() {
+  return [](const Exchange& e, double& estimate, bool& accepted) {
+    estimate = e.free_offset;
+    accepted = true;
+    return true;
+  };
+}
+
+Candidate MinRtt(const double mad_k) {
+  auto filter = std::make_shared<MinRttFilter>(32, mad_k);
+  auto last = std::make_shared<double>(NAN);
+  return [filter, last](const Exchange& e, double& estimate, bool& accepted) {
+    accepted = filter->Accept(e.delay_us);
+    if (accepted) {
+      *last = e.free_offset;
+    }
+    estimate = *last;
+    return !std::isnan(estimate);
+  };
+}
+
+Candidate Estimator(const size_t window, const double mad_k) {
+  auto filter = std::make_shared<MinRttFilter>(32, mad_k);
+  auto estimator = std::make_shared<ClockEstimator>(window);
+  return [filter, estimator](const Exchange& e, double& estimate, bool& accepted) {
+    accepted = filter->Accept(e.delay_us);
+    if (accepted) {
+      estimator->AddSample(e.host_us, std::llround(e.free_offset));
+    }
+    const ClockModel model = estimator->GetModel();
+    estimate = model.OffsetAt(e.host_us);
+    return model.valid;
+  };
+}
+
+// 在线运行时的实际决策：沿用记录中的接受标志
+Candidate Logged(const size_t window) {
+  auto estimator = std::make_shared<ClockEstimator>(window);
+  return [estimator](const Exchange& e, double& estimate, bool& accepted) {
+    accepted = e.accepted;
+    if (accepted) {
+      estimator->AddSample(e.host_us, std::llround(e.free_offset));
+    }
+    const ClockModel model = estimator->GetModel();
+    estimate = model.OffsetAt(e.host_us);
+    return model.valid;
+  };
+}
+
+Result Evaluate(const std::string& name, Candidate candidate, const std::vector<Exchange>& exchanges,
+                const std::vector<double>& reference, const double threshold_us) {
+  Result result;
+  result.name = name;
+  std::vector<double> errors;
+  // 收敛时间：此后误差一直不超过门限的最早时刻
+  uint64_t last_bad_us = exchanges.front().host_us;
+  bool converged = false;
+  double sum_sq = 0;
+  size_t accepted_count = 0;
+  for (size_t i = 0; i < exchanges.size(); ++i) {
+    double estimate = 0;
+    bool accepted = false;
+    const bool valid = candidate(exchanges[i], estimate, accepted);
+    accepted_count += accepted ? 1 : 0;
+    if (!valid) {
+      last_bad_us = exchanges[i].host_us;
+      converged = false;
+      continue;
+    }
+    const double error = std::abs(estimate - reference[i]);
+    errors.push_back(error);
+    sum_sq += error * error;
+    converged = error <= threshold_us;
+    if (!converged) {
+      last_bad_us = exchanges[i].host_us;
+    }
+  }
+  if (converged) {
+    result.converge_s = static_cast<double>(last_bad_us - exchanges.front().host_us) * 1e-6;
+  }
+  result.estimates = errors.size();
+  result.accept_rate = static_cast<double>(accepted_count) / static_cast<double>(exchanges.size());
+  if (!errors.empty()) {
+    std::sort(errors.begin(), errors.end());
+    result.rms_us = std::sqrt(sum_sq / static_cast<double>(errors.size()));
+    const auto p95 = static_cast<size_t>(0.95 * static_cast<double>(errors.size()));
+    result.p95_us = errors[std::min(errors.size() - 1, p95)];
+    result.max_us = errors.back();
+  }
+  return result;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  double threshold_us = 20;
+  std::string path;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-e" && i + 1 < argc) {
+      threshold_us = std::atof(argv[++i]);
+    } else {
+      path = arg;
+    }
+  }
+  if (path.empty()) {
+    std::cerr << "Usage: " << argv[0] << " [-e converge_threshold_us] exchange.bin\n";
+    return 1;
+  }
+  std::vector<Exchange> exchanges;
+  if (!Load(path, exchanges)) {
+    return 1;
+  }
+  if (exchanges.size() < 2) {
+    std::cerr << "Need at least 2 exchanges, got " << exchanges.size() << "\n";
+    return 1;
+  }
+  const std::vector<double> reference = Reference(exchanges);
+  const double duration_s = static_cast<double>(exchanges.back().host_us - exchanges.front().host_us) * 1e-6;
+  std::cout << exchanges.size() << " exchanges over " << std::fixed << std::setprecision(1) << duration_s
+            << " s, converge threshold " << threshold_us << " us\n";
+
+  const std::vector<std::pair<std::string, Candidate>> candidates = {
+      {"raw", Raw()},
+      {"min_rtt_k2", MinRtt(2.0)},
+      {"min_rtt_k4", MinRtt(4.0)},
+      {"min_rtt_k8", MinRtt(8.0)},
+      {"est16_k4", Estimator(16, 4.0)},
+      {"est64_k4", Estimator(64, 4.0)},
+      {"est64_k2", Estimator(64, 2.0)},
+      {"logged_est64", Logged(64)},
+  };
+
+  std::cout << std::left << std::setw(16) << "candidate" << std::right << std::setw(10) << "rms_us" << std::setw(10)
+            << "p95_us" << std::setw(10) << "max_us" << std::setw(14) << "converge_s" << std::setw(10) << "samples"
+            << std::setw(10) << "accept" << "\n";
+  for (const auto& [name, candidate] : candidates) {
+    const Result r = Evaluate(name, candidate, exchanges, reference, threshold_us);
+    std::cout << std::left << std::setw(16) << r.name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << r.rms_us << std::setw(10) << r.p95_us << std::setw(10) << r.max_us << std::setw(14);
+    if (r.converge_s < 0) {
+      std::cout << "never";
+    } else {
+      std::cout << std::setprecision(2) << r.converge_s;
+    }
+    std::cout << std::setw(10) << r.estimates << std::setw(9) << std::setprecision(1) << 100 * r.accept_rate
+              << "%\n";
+  }
+  return 0;
+}